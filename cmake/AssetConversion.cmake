@@ -0,0 +1,137 @@
+# Incremental asset conversion
+#
+# Splits assets/manifest.json into one single-entry manifest per source and adds a build step for each, so only
+# entries whose inputs changed are reconverted, and independent entries convert in parallel. Each step hashes its
+# source file together with its manifest options and skips nc-convert when that matches assets/manifest.lock and
+# the outputs exist. The lockfile is rewritten after every run, so fresh build trees don't reconvert everything.
+
+# nc-convert isn't fetched with the engine, so it has to be on PATH, in the engine's build tree, or given explicitly
+find_program(NC_CONVERT_EXECUTABLE
+    NAMES "nc-convert${CMAKE_EXECUTABLE_SUFFIX}"
+    HINTS "${PROJECT_BINARY_DIR}/_deps/ncengine-build"
+    PATH_SUFFIXES "tools/nc-convert" "bin"
+    DOC "Path to nc-convert"
+)
+
+if(NOT NC_CONVERT_EXECUTABLE)
+    message(FATAL_ERROR "GAME_CONVERT_ASSETS requires nc-convert. Add it to PATH or set NC_CONVERT_EXECUTABLE.")
+endif()
+
+set(GAME_ASSET_ROOT "${PROJECT_SOURCE_DIR}/assets")
+set(GAME_ASSET_MANIFEST "${GAME_ASSET_ROOT}/manifest.json")
+set(GAME_ASSET_LOCK "${GAME_ASSET_ROOT}/manifest.lock")
+set(GAME_ASSET_WORK_DIR "${PROJECT_BINARY_DIR}/asset_conversion")
+set(GAME_ASSET_SCRIPT "${PROJECT_SOURCE_DIR}/cmake/ConvertAsset.cmake")
+
+set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS "${GAME_ASSET_MANIFEST}")
+file(READ "${GAME_ASSET_MANIFEST}" manifest)
+
+# Outputs are written with absolute paths, but options are hashed as written so the lockfile is portable
+string(JSON globalOptions GET "${manifest}" globalOptions)
+string(JSON globalOptionsAbsolute SET "${globalOptions}" outputDirectory "\"${GAME_ASSET_ROOT}/nca\"")
+
+# Only rewrite generated files when they change, otherwise every configure would reconvert everything
+function(game_write_if_changed path content)
+    if(EXISTS "${path}")
+        file(READ "${path}" existing)
+        if(existing STREQUAL content)
+            return()
+        endif()
+    endif()
+
+    file(WRITE "${path}" "${content}")
+endfunction()
+
+set(stamps "")
+string(JSON typeCount LENGTH "${manifest}")
+math(EXPR lastType "${typeCount} - 1")
+foreach(typeIndex RANGE ${lastType})
+    string(JSON type MEMBER "${manifest}" ${typeIndex})
+    if(type STREQUAL "globalOptions")
+        continue()
+    endif()
+
+    string(JSON entryCount LENGTH "${manifest}" ${type})
+    if(entryCount EQUAL 0)
+        continue()
+    endif()
+
+    math(EXPR lastEntry "${entryCount} - 1")
+    foreach(entryIndex RANGE ${lastEntry})
+        string(JSON entry GET "${manifest}" ${type} ${entryIndex})
+        string(JSON sourcePath GET "${entry}" sourcePath)
+        set(sourcePath "${GAME_ASSET_ROOT}/${sourcePath}")
+        if(NOT EXISTS "${sourcePath}")
+            message(WARNING "Skipping conversion of missing asset source '${sourcePath}'")
+            continue()
+        endif()
+
+        # Single asset entries use 'assetName', multi-resource sources (e.g. fbx animations) use 'assetNames'
+        set(assetNames "")
+        string(JSON assetName ERROR_VARIABLE noAssetName GET "${entry}" assetName)
+        if(noAssetName)
+            string(JSON nameCount LENGTH "${entry}" assetNames)
+            math(EXPR lastName "${nameCount} - 1")
+            foreach(nameIndex RANGE ${lastName})
+                string(JSON assetName GET "${entry}" assetNames ${nameIndex} assetName)
+                string(REPLACE "\\" "/" assetName "${assetName}")
+                list(APPEND assetNames "${assetName}")
+            endforeach()
+        else()
+            string(REPLACE "\\" "/" assetName "${assetName}")
+            list(APPEND assetNames "${assetName}")
+        endif()
+
+        list(GET assetNames 0 entryKey)
+        list(TRANSFORM assetNames PREPEND "${GAME_ASSET_ROOT}/nca/")
+        list(TRANSFORM assetNames APPEND ".nca")
+        string(JOIN "|" outputs ${assetNames})
+        string(SHA256 optionsHash "${globalOptions}${type}${entry}")
+
+        string(MAKE_C_IDENTIFIER "${entryKey}" entryId)
+        set(entryManifest "${GAME_ASSET_WORK_DIR}/${entryId}.json")
+        set(entryStamp "${GAME_ASSET_WORK_DIR}/${entryId}.stamp")
+        string(JSON absoluteEntry SET "${entry}" sourcePath "\"${sourcePath}\"")
+        game_write_if_changed("${entryManifest}" "{\"globalOptions\": ${globalOptionsAbsolute}, \"${type}\": [${absoluteEntry}]}")
+
+        add_custom_command(
+            OUTPUT  "${entryStamp}"
+            COMMAND ${CMAKE_COMMAND}
+                    "-DNC_CONVERT=${NC_CONVERT_EXECUTABLE}"
+                    "-DENTRY_KEY=${entryKey}"
+                    "-DENTRY_MANIFEST=${entryManifest}"
+                    "-DSOURCE=${sourcePath}"
+                    "-DOPTIONS_HASH=${optionsHash}"
+                    "-DOUTPUTS=${outputs}"
+                    "-DLOCK_FILE=${GAME_ASSET_LOCK}"
+                    "-DSTAMP=${entryStamp}"
+                    -P "${GAME_ASSET_SCRIPT}"
+            DEPENDS "${sourcePath}" "${entryManifest}" "${GAME_ASSET_SCRIPT}"
+            WORKING_DIRECTORY "${GAME_ASSET_ROOT}"
+            COMMENT "Converting ${entryKey}"
+            VERBATIM
+        )
+
+        list(APPEND stamps "${entryStamp}")
+    endforeach()
+endforeach()
+
+# Entries removed from the manifest leave stale stamps behind, so the merge reads the current set from here
+list(JOIN stamps "\n" stampList)
+game_write_if_changed("${GAME_ASSET_WORK_DIR}/entries.txt" "${stampList}\n")
+
+set(lockStamp "${GAME_ASSET_WORK_DIR}/manifest.lock.stamp")
+add_custom_command(
+    OUTPUT  "${lockStamp}"
+    COMMAND ${CMAKE_COMMAND}
+            -DMERGE_LOCK=ON
+            "-DENTRY_LIST=${GAME_ASSET_WORK_DIR}/entries.txt"
+            "-DLOCK_FILE=${GAME_ASSET_LOCK}"
+            "-DSTAMP=${lockStamp}"
+            -P "${GAME_ASSET_SCRIPT}"
+    DEPENDS ${stamps} "${GAME_ASSET_WORK_DIR}/entries.txt"
+    COMMENT "Updating asset lockfile"
+    VERBATIM
+)
+
+add_custom_target(convert-assets ALL DEPENDS "${lockStamp}")
@@ -0,0 +1,59 @@
+# Script mode helper for AssetConversion.cmake
+#
+# Convert:    -DNC_CONVERT -DENTRY_KEY -DENTRY_MANIFEST -DSOURCE -DOPTIONS_HASH -DOUTPUTS -DLOCK_FILE -DSTAMP
+#             Converts one manifest entry unless its hash matches the lockfile, then stamps '<key> <hash>'.
+# Merge lock: -DMERGE_LOCK=ON -DENTRY_LIST -DLOCK_FILE -DSTAMP
+#             Rewrites the lockfile from the entry stamps listed in ENTRY_LIST.
+
+cmake_minimum_required(VERSION 3.20)
+
+if(MERGE_LOCK)
+    file(STRINGS "${ENTRY_LIST}" entryStamps)
+    set(lines "")
+    foreach(entryStamp ${entryStamps})
+        file(READ "${entryStamp}" line)
+        string(STRIP "${line}" line)
+        list(APPEND lines "${line}")
+    endforeach()
+
+    list(SORT lines)
+    list(JOIN lines "\n" lock)
+    set(lock "${lock}\n")
+    set(existing "")
+    if(EXISTS "${LOCK_FILE}")
+        file(READ "${LOCK_FILE}" existing)
+    endif()
+
+    if(NOT existing STREQUAL lock)
+        file(WRITE "${LOCK_FILE}" "${lock}")
+    endif()
+
+    file(TOUCH "${STAMP}")
+    return()
+endif()
+
+file(SHA256 "${SOURCE}" sourceHash)
+string(SHA256 hash "${sourceHash}${OPTIONS_HASH}")
+set(entryLine "${ENTRY_KEY} ${hash}")
+
+set(upToDate FALSE)
+if(EXISTS "${LOCK_FILE}")
+    file(STRINGS "${LOCK_FILE}" lockLines)
+    if("${entryLine}" IN_LIST lockLines)
+        set(upToDate TRUE)
+        string(REPLACE "|" ";" outputs "${OUTPUTS}")
+        foreach(output ${outputs})
+            if(NOT EXISTS "${output}")
+                set(upToDate FALSE)
+            endif()
+        endforeach()
+    endif()
+endif()
+
+if(upToDate)
+    message(STATUS "${ENTRY_KEY} is up to date")
+else()
+    execute_process(COMMAND "${NC_CONVERT}" -m "${ENTRY_MANIFEST}" COMMAND_ERROR_IS_FATAL ANY)
+endif()
+
+file(WRITE "${STAMP}" "${entryLine}\n")
@@ -0,0 +1,206 @@
+#include "AnimationCrowd.h"
+#include "AssetResidency.h"
+#include "FollowCamera.h"
+
+#include "ncengine/window/Window.h"
+
+namespace
+{
+auto NeverExit() -> bool
+{
+    return false;
+}
+
+// Half angle of the view's diagonal, so anything outside it is off-screen whatever the aspect ratio
+auto HalfViewAngle(float tanHalfFov) -> float
+{
+    const auto dimensions = nc::window::GetDimensions();
+    const auto aspect = dimensions.y > 0.0f ? dimensions.x / dimensions.y : 1.0f;
+    return std::atan(tanHalfFov * std::sqrt(1.0f + aspect * aspect));
+}
+} // anonymous namespace
+
+namespace game
+{
+AnimationCrowd::AnimationCrowd(nc::Entity self)
+    : nc::FreeComponent{self}
+{
+}
+
+void AnimationCrowd::Add(nc::ecs::Ecs world, nc::Entity entity, std::string_view mesh, std::string_view clip)
+{
+    const auto state = Enter(mesh, clip);
+    const auto phase = std::fmod(static_cast<float>(m_states[state].members - 1u) * PhaseStep, MaxPhase);
+    m_members.emplace_back(entity, state, state, phase, FreezeCooldown, 0.0f, true, false);
+    world.Emplace<nc::graphics::SkeletalAnimator>(entity, std::string{mesh}, std::string{clip});
+}
+
+void AnimationCrowd::Loop(nc::ecs::Ecs world, nc::Entity entity, std::string_view clip)
+{
+    Move(world, Find(entity), clip, true)->LoopImmediate(std::string{clip}, ::NeverExit);
+}
+
+void AnimationCrowd::PlayOnce(nc::ecs::Ecs world, nc::Entity entity, std::string_view clip)
+{
+    auto& member = Find(entity);
+    Move(world, member, clip, false)->PlayOnceImmediate(std::string{clip});
+    member.oneShotFor = AssetResidency::Instance().GetAnimationDuration(clip);
+}
+
+void AnimationCrowd::ReturnToRoot(nc::ecs::Ecs world, nc::Entity entity)
+{
+    auto& member = Find(entity);
+    Move(world, member, m_states[member.root].clip, true)->StopImmediate([](){ return true; });
+}
+
+void AnimationCrowd::Release()
+{
+    for (const auto& state : m_states)
+    {
+        if (state.members != 0u)
+            AssetResidency::Instance().Release(state.clip);
+    }
+
+    m_states.clear();
+    m_members.clear();
+    m_frozenCount = 0ull;
+}
+
+void AnimationCrowd::Run(nc::Entity, nc::Registry* registry, float dt)
+{
+    auto world = registry->GetEcs();
+    for (auto& member : m_members)
+    {
+        member.cooldown -= dt;
+        if (!member.looping)
+        {
+            // The animator blends back to its root state on its own, so only the bookkeeping needs to follow
+            member.oneShotFor -= dt;
+            if (member.oneShotFor <= 0.0f)
+                SetState(member, m_states[member.root].clip, true);
+
+            continue;
+        }
+
+        if (member.startIn <= 0.0f)
+            continue;
+
+        member.startIn -= dt;
+        if (member.startIn <= 0.0f && !member.frozen)
+            world.Get<nc::graphics::SkeletalAnimator>(member.entity)->LoopImmediate(m_states[member.state].clip, ::NeverExit);
+    }
+
+    if (m_camera.Valid())
+        UpdateFreezing(world);
+
+    GetAnimationFreezeStats() = AnimationFreezeStats{m_frozenCount, m_members.size()};
+}
+
+auto AnimationCrowd::Find(nc::Entity entity) -> Member&
+{
+    const auto pos = std::ranges::find(m_members, entity, &Member::entity);
+    NC_ASSERT(pos != m_members.end(), "expected entity to be in the animation crowd");
+    return *pos;
+}
+
+auto AnimationCrowd::Enter(std::string_view mesh, std::string_view clip) -> size_t
+{
+    const auto pos = std::ranges::find_if(m_states, [mesh, clip](const State& state)
+    {
+        return state.mesh == mesh && state.clip == clip;
+    });
+
+    if (pos != m_states.end())
+    {
+        if (pos->members++ == 0u)
+            AssetResidency::Instance().Acquire(AssetType::SkeletalAnimation, clip);
+
+        return static_cast<size_t>(std::distance(m_states.begin(), pos));
+    }
+
+    AssetResidency::Instance().Acquire(AssetType::SkeletalAnimation, clip);
+    m_states.emplace_back(std::string{mesh}, std::string{clip}, 1u);
+    return m_states.size() - 1;
+}
+
+void AnimationCrowd::Leave(size_t state)
+{
+    // States are kept once seen, as root states are always returned to
+    if (--m_states[state].members == 0u)
+        AssetResidency::Instance().Release(m_states[state].clip);
+}
+
+// Returns the member's animator, restarting it if frozen, for the caller to play the new state on
+auto AnimationCrowd::Move(nc::ecs::Ecs world, Member& member, std::string_view clip, bool looping) -> nc::graphics::SkeletalAnimator*
+{
+    SetState(member, clip, looping);
+    member.startIn = 0.0f; // any late start is moot, the caller restarts the animator
+    return member.frozen ? Thaw(world, member) : world.Get<nc::graphics::SkeletalAnimator>(member.entity);
+}
+
+void AnimationCrowd::SetState(Member& member, std::string_view clip, bool looping)
+{
+    // Enter first, so staying in the same state doesn't release and reacquire its clip
+    const auto state = Enter(m_states[member.state].mesh, clip);
+    Leave(member.state);
+    member.state = state;
+    member.cooldown = FreezeCooldown;
+    member.looping = looping;
+}
+
+void AnimationCrowd::UpdateFreezing(nc::ecs::Ecs world)
+{
+    const auto camera = world.Get<nc::Transform>(m_camera);
+    const auto cameraPosition = camera->Position();
+    const auto cameraForward = camera->Forward();
+    const auto tanHalfFov = std::tan(FollowCamera::CameraProperties.fov * 0.5f);
+    const auto halfViewAngle = ::HalfViewAngle(tanHalfFov);
+
+    for (auto& member : m_members)
+    {
+        const auto offset = world.Get<nc::Transform>(member.entity)->Position() - cameraPosition;
+        const auto distance = nc::Magnitude(offset);
+        if (distance <= BoundingRadius)
+        {
+            if (member.frozen)
+                Thaw(world, member);
+
+            continue;
+        }
+
+        // Angle between the view direction and the bounding sphere's nearest edge
+        const auto cosAngle = std::clamp(nc::Dot(offset / distance, cameraForward), -1.0f, 1.0f);
+        const auto edgeAngle = std::acos(cosAngle) - std::asin(BoundingRadius / distance);
+        if (member.frozen)
+        {
+            if (edgeAngle < halfViewAngle + ThawViewMargin)
+                Thaw(world, member);
+        }
+        else if (member.looping && member.cooldown <= 0.0f && edgeAngle > halfViewAngle)
+        {
+            Freeze(world, member);
+        }
+    }
+}
+
+void AnimationCrowd::Freeze(nc::ecs::Ecs world, Member& member)
+{
+    world.Remove<nc::graphics::SkeletalAnimator>(member.entity);
+    member.frozen = true;
+    member.startIn = 0.0f; // it restarts from the beginning anyway
+    ++m_frozenCount;
+}
+
+auto AnimationCrowd::Thaw(nc::ecs::Ecs world, Member& member) -> nc::graphics::SkeletalAnimator*
+{
+    const auto& state = m_states[member.state];
+    auto animator = world.Emplace<nc::graphics::SkeletalAnimator>(member.entity, state.mesh, m_states[member.root].clip);
+    if (member.state != member.root)
+        animator->LoopImmediate(state.clip, ::NeverExit);
+
+    member.frozen = false;
+    member.cooldown = FreezeCooldown; // a new animator is staged until the end of the frame, so mustn't be removed yet
+    --m_frozenCount;
+    return animator;
+}
+} // namespace game
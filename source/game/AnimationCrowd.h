@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Core.h"
+
+namespace game
+{
+// Animators in the crowd as of its last Run. A frozen animator skips evaluating its whole skeleton every frame. There's
+// no distance-based update rate in between - SkeletalAnimator always evaluates every frame while it exists.
+struct AnimationFreezeStats
+{
+    size_t frozen = 0;
+    size_t animators = 0;
+};
+
+inline auto GetAnimationFreezeStats() -> AnimationFreezeStats&
+{
+    static auto stats = AnimationFreezeStats{};
+    return stats;
+}
+
+// Owns the animators for characters that share meshes and clips, and tracks which (mesh, clip) state each is in.
+// Animators joining a state that's already playing start a little late, so a crowd on the same clip doesn't move in
+// lockstep. A clip is held through AssetResidency while anything is in its state, and released once nothing is. Members
+// of a state still evaluate their poses separately - the engine doesn't let animators share a skinning palette.
+//
+// Looping animators are frozen (their SkeletalAnimator removed) while off-screen, and restarted in their current state a
+// little before they come back into view. SkeletalAnimator can't be paused, so a thawed animator starts its clip over -
+// the margin is there so that happens out of sight. One-shots return the animator to its root state once the clip has
+// played.
+class AnimationCrowd : public nc::FreeComponent
+{
+    public:
+        static constexpr auto PhaseStep = 0.4f;
+        static constexpr auto MaxPhase = 1.6f; // stays under the title screen's hold in darkness
+        static constexpr auto BoundingRadius = 2.5f; // roughly a sasquatch
+        static constexpr auto ThawViewMargin = 0.15f; // radians outside the view to restart within
+        static constexpr auto FreezeCooldown = 0.5f; // seconds after any change before an animator can freeze
+
+        explicit AnimationCrowd(nc::Entity self);
+
+        void RegisterCamera(nc::Entity camera) { m_camera = camera; }
+
+        // 'clip' becomes the animator's root state
+        void Add(nc::ecs::Ecs world, nc::Entity entity, std::string_view mesh, std::string_view clip);
+
+        void Loop(nc::ecs::Ecs world, nc::Entity entity, std::string_view clip);
+        void PlayOnce(nc::ecs::Ecs world, nc::Entity entity, std::string_view clip);
+        void ReturnToRoot(nc::ecs::Ecs world, nc::Entity entity);
+
+        // Releases every clip still held and forgets all members, for when the scene is torn down
+        void Release();
+
+        void Run(nc::Entity self, nc::Registry* registry, float dt);
+
+    private:
+        struct State
+        {
+            std::string mesh;
+            std::string clip;
+            uint32_t members;
+        };
+
+        struct Member
+        {
+            nc::Entity entity;
+            size_t state;
+            size_t root;
+            float startIn; // seconds until a late start restarts the clip
+            float cooldown;
+            float oneShotFor; // seconds until a one-shot ends and the root state resumes
+            bool looping;
+            bool frozen;
+        };
+
+        std::vector<State> m_states;
+        std::vector<Member> m_members;
+        nc::Entity m_camera = nc::Entity::Null();
+        size_t m_frozenCount = 0ull;
+
+        auto Find(nc::Entity entity) -> Member&;
+        auto Enter(std::string_view mesh, std::string_view clip) -> size_t;
+        void Leave(size_t state);
+        void SetState(Member& member, std::string_view clip, bool looping);
+        auto Move(nc::ecs::Ecs world, Member& member, std::string_view clip, bool looping) -> nc::graphics::SkeletalAnimator*;
+        void UpdateFreezing(nc::ecs::Ecs world);
+        void Freeze(nc::ecs::Ecs world, Member& member);
+        auto Thaw(nc::ecs::Ecs world, Member& member) -> nc::graphics::SkeletalAnimator*;
+};
+} // namespace game
@@ -0,0 +1,226 @@
+#include "AssetResidency.h"
+#include "Assets.h"
+
+#include "ncengine/asset/Assets.h"
+#include "ncengine/utility/Log.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+
+namespace
+{
+// .nca audio clips begin with: magic | compression | hash | size | samplesPerChannel
+constexpr auto AudioClipSampleCountOffset = 24ull;
+// .nca skeletal animations begin with the same header, then: nameLength | name | durationInTicks | ticksPerSecond
+constexpr auto AnimationNameLengthOffset = 24ull;
+// The clip header has no sample rate. nc-convert writes every clip at the engine's fixed 44.1kHz output rate, so a
+// change to that rate in the engine has to be made here too.
+constexpr auto AudioSampleRate = 44100.0;
+
+constexpr auto OnDemandAssets = std::array<std::string_view, 7>{
+    game::BlightClearedMusic,
+    game::LoseMusic,
+    game::EndingMusic,
+    game::TitleScreenParticle,
+    game::DaveWave,
+    game::DaveStandupStump,
+    game::DaveStandupGround
+};
+
+void LoadAsset(game::AssetType type, const std::string& name)
+{
+    switch (type)
+    {
+        case game::AssetType::AudioClip:         { nc::LoadAudioClipAsset(name);         break; }
+        case game::AssetType::SkeletalAnimation: { nc::LoadSkeletalAnimationAsset(name); break; }
+        case game::AssetType::Texture:           { nc::LoadTextureAsset(name);           break; }
+    }
+}
+
+auto ReadAudioClipSampleCount(std::string_view name, const std::filesystem::path& directory) -> uint64_t
+{
+    auto samples = uint64_t{0};
+    if (auto file = std::ifstream{directory / name, std::ios::binary})
+    {
+        file.seekg(AudioClipSampleCountOffset);
+        file.read(reinterpret_cast<char*>(&samples), sizeof(samples));
+        if (!file)
+            samples = 0;
+    }
+
+    return samples;
+}
+
+auto ReadAnimationDuration(const std::filesystem::path& path) -> float
+{
+    auto file = std::ifstream{path, std::ios::binary};
+    auto nameLength = uint64_t{0};
+    auto ticks = uint32_t{0};
+    auto ticksPerSecond = 0.0f;
+    file.seekg(AnimationNameLengthOffset);
+    file.read(reinterpret_cast<char*>(&nameLength), sizeof(nameLength));
+    file.seekg(static_cast<std::streamoff>(nameLength), std::ios::cur);
+    file.read(reinterpret_cast<char*>(&ticks), sizeof(ticks));
+    file.read(reinterpret_cast<char*>(&ticksPerSecond), sizeof(ticksPerSecond));
+    if (!file || ticksPerSecond <= 0.0f)
+        return 0.0f;
+
+    return static_cast<float>(ticks) / ticksPerSecond;
+}
+
+void UnloadAsset(game::AssetType type, const std::string& name)
+{
+    switch (type)
+    {
+        case game::AssetType::AudioClip:         { nc::UnloadAudioClipAsset(name);         break; }
+        case game::AssetType::SkeletalAnimation: { nc::UnloadSkeletalAnimationAsset(name); break; }
+        case game::AssetType::Texture:           { nc::UnloadTextureAsset(name);           break; }
+    }
+}
+} // anonymous namespace
+
+namespace game
+{
+auto IsOnDemandAsset(std::string_view name) -> bool
+{
+    return std::ranges::find(OnDemandAssets, name) != OnDemandAssets.end();
+}
+
+auto IsLongAudioClip(std::string_view name, const std::filesystem::path& directory) -> bool
+{
+    const auto samples = ::ReadAudioClipSampleCount(name, directory);
+    return static_cast<double>(samples) / AudioSampleRate >= LongAudioClipMinDuration;
+}
+
+AssetResidency::AssetResidency(const nc::config::AssetSettings& settings, size_t budget)
+    : m_settings{settings},
+      m_budget{budget}
+{
+    NC_ASSERT(!AssetResidency::m_instance, "Already an AssetResidency instance");
+    AssetResidency::m_instance = this;
+}
+
+AssetResidency::~AssetResidency() noexcept
+{
+    AssetResidency::m_instance = nullptr;
+}
+
+auto AssetResidency::Instance() -> AssetResidency&
+{
+    NC_ASSERT(AssetResidency::m_instance, "No AssetResidency instance");
+    return *AssetResidency::m_instance;
+}
+
+void AssetResidency::Acquire(AssetType type, std::string_view name)
+{
+    if (IsOnDemandAsset(name) || IsLongClip(type, name))
+        ++Touch(type, name).holds;
+}
+
+void AssetResidency::Release(std::string_view name)
+{
+    auto pos = std::ranges::find(m_resident, name, &Resident::name);
+    if (pos == m_resident.end() || pos->holds == 0)
+        return;
+
+    if (--pos->holds == 0 && pos->longClip)
+        Unload(pos);
+}
+
+void AssetResidency::Prefetch(AssetType type, std::string_view name)
+{
+    if (IsOnDemandAsset(name) || IsLongClip(type, name))
+        Touch(type, name);
+}
+
+auto AssetResidency::IsLongClip(AssetType type, std::string_view name) -> bool
+{
+    if (type != AssetType::AudioClip)
+        return false;
+
+    // Every Acquire, Release and Prefetch asks, so each clip's header is only read once
+    auto pos = std::ranges::find(m_longClips, name, &LongClipEntry::name);
+    if (pos == m_longClips.end())
+        pos = m_longClips.insert(m_longClips.end(), LongClipEntry{std::string{name}, IsLongAudioClip(name, m_settings.audioClipsPath)});
+
+    return pos->isLong;
+}
+
+auto AssetResidency::Touch(AssetType type, std::string_view name) -> Resident&
+{
+    auto pos = std::ranges::find(m_resident, name, &Resident::name);
+    if (pos != m_resident.end())
+    {
+        pos->lastUse = ++m_useCounter;
+        return *pos;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto& resident = m_resident.emplace_back(std::string{name}, type, GetAssetSize(type, name), ++m_useCounter, 0u, IsLongClip(type, name));
+    ::LoadAsset(type, resident.name);
+    m_residentSize += resident.size;
+    NC_LOG_INFO(fmt::format("Loaded on-demand asset '{}' in {:.2f}ms",
+        name, std::chrono::duration<double, std::milli>{std::chrono::steady_clock::now() - start}.count()));
+
+    EvictOverBudget();
+    return *std::ranges::find(m_resident, name, &Resident::name);
+}
+
+void AssetResidency::EvictOverBudget()
+{
+    while (m_residentSize > m_budget)
+    {
+        auto victim = m_resident.end();
+        for (auto pos = m_resident.begin(); pos != m_resident.end(); ++pos)
+        {
+            // The most recent use is what triggered this, so it always stays
+            if (pos->holds == 0 && pos->lastUse != m_useCounter && (victim == m_resident.end() || pos->lastUse < victim->lastUse))
+                victim = pos;
+        }
+
+        // Everything else is in use, so just run over budget for now
+        if (victim == m_resident.end())
+            return;
+
+        Unload(victim);
+    }
+}
+
+void AssetResidency::Unload(std::vector<Resident>::iterator pos)
+{
+    NC_LOG_INFO(fmt::format("Unloading on-demand asset '{}'", pos->name));
+    ::UnloadAsset(pos->type, pos->name);
+    m_residentSize -= pos->size;
+    m_resident.erase(pos);
+}
+
+auto AssetResidency::GetAnimationDuration(std::string_view name) const -> float
+{
+    const auto duration = ::ReadAnimationDuration(GetAssetPath(AssetType::SkeletalAnimation, name));
+    if (duration <= 0.0f)
+        NC_LOG_WARNING(fmt::format("Failed to read the duration of animation '{}'", name));
+
+    return duration;
+}
+
+auto AssetResidency::GetAssetPath(AssetType type, std::string_view name) const -> std::filesystem::path
+{
+    switch (type)
+    {
+        case AssetType::AudioClip:         return std::filesystem::path{m_settings.audioClipsPath} / name;
+        case AssetType::SkeletalAnimation: return std::filesystem::path{m_settings.skeletalAnimationsPath} / name;
+        case AssetType::Texture:           return std::filesystem::path{m_settings.texturesPath} / name;
+    }
+
+    return std::filesystem::path{name};
+}
+
+auto AssetResidency::GetAssetSize(AssetType type, std::string_view name) const -> size_t
+{
+    auto error = std::error_code{};
+    const auto size = std::filesystem::file_size(GetAssetPath(type, name), error);
+    return error ? 0ull : static_cast<size_t>(size);
+}
+} // namespace game
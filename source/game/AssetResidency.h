@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ncengine/config/Config.h"
+#include "ncengine/type/StableAddress.h"
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace game
+{
+enum class AssetType : uint8_t
+{
+    AudioClip,
+    SkeletalAnimation,
+    Texture
+};
+
+// Upper bound on memory held by on-demand assets that aren't currently in use
+constexpr auto OnDemandAssetBudget = 12ull * 1024ull * 1024ull;
+
+// Audio clips at least this long are never decoded at startup. They're loaded when prefetched or acquired, and unloaded
+// as soon as the last hold is released.
+constexpr auto LongAudioClipMinDuration = 15.0f;
+
+// Assets that aren't needed until later in the story (or only briefly). LoadAssets skips these, and they are
+// brought in through AssetResidency on first use instead.
+auto IsOnDemandAsset(std::string_view name) -> bool;
+
+// Whether a clip is at least LongAudioClipMinDuration, based on the sample count in its header
+auto IsLongAudioClip(std::string_view name, const std::filesystem::path& directory) -> bool;
+
+// Loads on-demand assets as they're needed and unloads the least recently used ones that nothing holds once over
+// budget. Long audio clips are unloaded as soon as nothing holds them. Requests for assets that are neither are
+// ignored, as those stay loaded for the whole game.
+class AssetResidency : public nc::StableAddress
+{
+    public:
+        AssetResidency(const nc::config::AssetSettings& settings, size_t budget);
+        ~AssetResidency() noexcept;
+
+        static auto Instance() -> AssetResidency&;
+
+        // Load if needed and keep loaded until released
+        void Acquire(AssetType type, std::string_view name);
+        void Release(std::string_view name);
+
+        // Load ahead of a known event without holding it, so the later Acquire is free
+        void Prefetch(AssetType type, std::string_view name);
+
+        // Seconds, read from the clip's header, or zero if it can't be read
+        auto GetAnimationDuration(std::string_view name) const -> float;
+
+    private:
+        struct Resident
+        {
+            std::string name;
+            AssetType type;
+            size_t size;
+            uint64_t lastUse;
+            uint32_t holds;
+            bool longClip;
+        };
+
+        struct LongClipEntry
+        {
+            std::string name;
+            bool isLong;
+        };
+
+        inline static AssetResidency* m_instance = nullptr;
+        nc::config::AssetSettings m_settings;
+        std::vector<Resident> m_resident;
+        std::vector<LongClipEntry> m_longClips;
+        size_t m_budget;
+        size_t m_residentSize = 0ull;
+        uint64_t m_useCounter = 0ull;
+
+        auto IsLongClip(AssetType type, std::string_view name) -> bool;
+        auto Touch(AssetType type, std::string_view name) -> Resident&;
+        void Unload(std::vector<Resident>::iterator pos);
+        void EvictOverBudget();
+        auto GetAssetPath(AssetType type, std::string_view name) const -> std::filesystem::path;
+        auto GetAssetSize(AssetType type, std::string_view name) const -> size_t;
+};
+} // namespace game
@@ -1,15 +1,42 @@
 #include "Assets.h"
+#include "AssetResidency.h"
 
 #include "ncengine/asset/Assets.h"
 #include "ncengine/config/Config.h"
+#include "ncengine/utility/Log.h"
 
+#include <array>
+#include <chrono>
 #include <filesystem>
 
 namespace
 {
-template<class LoadFunc>
-void LoadAssets(const std::filesystem::path& rootDir, nc::asset_flags_type flags, LoadFunc load)
+using clock_type = std::chrono::steady_clock;
+using load_func_t = void(*)(const std::vector<std::string>&);
+
+template<auto LoadFunc>
+void Load(const std::vector<std::string>& paths)
+{
+    LoadFunc(paths, false, nc::AssetFlags::None);
+}
+
+struct AssetCategory
+{
+    std::string_view name;
+    std::string_view rootDir;
+    load_func_t load;
+    bool audio = false;
+};
+
+auto ToMilliseconds(clock_type::duration duration) -> double
+{
+    return std::chrono::duration<double, std::milli>{duration}.count();
+}
+
+// Everything in the category that's loaded at startup, relative to its root
+auto FindStartupAssets(const AssetCategory& category) -> std::vector<std::string>
 {
+    const auto rootDir = std::filesystem::path{category.rootDir};
     auto paths = std::vector<std::string>{};
     for (auto&& entry : std::filesystem::recursive_directory_iterator{rootDir})
     {
@@ -18,19 +45,16 @@ void LoadAssets(const std::filesystem::path& rootDir, nc::asset_flags_type flags
             continue;
         }
 
-        const auto& path = entry.path();
-        auto trimmedPath = std::filesystem::path{};
-        auto segment = path.begin();
-        ++segment; ++segment; ++segment; // super hacky and brittle
-        for (; segment != path.end(); ++segment)
+        auto path = entry.path().lexically_relative(rootDir).string();
+        if (game::IsOnDemandAsset(path) || (category.audio && game::IsLongAudioClip(path, rootDir)))
         {
-            trimmedPath /= *segment;
+            continue;
         }
 
-        paths.push_back(trimmedPath.string());
+        paths.push_back(std::move(path));
     }
 
-    load(paths, false, flags);
+    return paths;
 }
 } // anonymous namespace
 
@@ -38,11 +62,25 @@ namespace game
 {
 void LoadAssets(const nc::config::AssetSettings& settings)
 {
-    ::LoadAssets(settings.audioClipsPath, nc::AssetFlags::None, &nc::LoadAudioClipAssets);
-    ::LoadAssets(settings.meshesPath, nc::AssetFlags::None, &nc::LoadMeshAssets);
-    ::LoadAssets(settings.texturesPath, nc::AssetFlags::None, &nc::LoadTextureAssets);
-    ::LoadAssets(settings.concaveCollidersPath, nc::AssetFlags::None, &nc::LoadConcaveColliderAssets);
-    ::LoadAssets(settings.cubeMapsPath, nc::AssetFlags::None, &nc::LoadCubeMapAssets);
-    ::LoadAssets(settings.skeletalAnimationsPath, nc::AssetFlags::None, &nc::LoadSkeletalAnimationAssets);
+    const auto start = clock_type::now();
+    const auto categories = std::array{
+        ::AssetCategory{"audio clip", settings.audioClipsPath, &::Load<&nc::LoadAudioClipAssets>, true},
+        ::AssetCategory{"mesh", settings.meshesPath, &::Load<&nc::LoadMeshAssets>, false},
+        ::AssetCategory{"texture", settings.texturesPath, &::Load<&nc::LoadTextureAssets>, false},
+        ::AssetCategory{"concave collider", settings.concaveCollidersPath, &::Load<&nc::LoadConcaveColliderAssets>, false},
+        ::AssetCategory{"cube map", settings.cubeMapsPath, &::Load<&nc::LoadCubeMapAssets>, false},
+        ::AssetCategory{"skeletal animation", settings.skeletalAnimationsPath, &::Load<&nc::LoadSkeletalAnimationAssets>, false}
+    };
+
+    // The engine's asset managers aren't known to be safe to call concurrently, so categories load one at a time
+    for (const auto& category : categories)
+    {
+        const auto categoryStart = clock_type::now();
+        const auto paths = ::FindStartupAssets(category);
+        category.load(paths);
+        NC_LOG_INFO(fmt::format("Loaded {} {} assets in {:.2f}ms", paths.size(), category.name, ::ToMilliseconds(clock_type::now() - categoryStart)));
+    }
+
+    NC_LOG_INFO(fmt::format("Loaded all assets in {:.2f}ms", ::ToMilliseconds(clock_type::now() - start)));
 }
 } // namespace game
@@ -0,0 +1,189 @@
+#include "BotDriver.h"
+#include "Character.h"
+#include "GameInput.h"
+#include "GameplayOrchestrator.h"
+#include "InfectedTreeIndex.h"
+#include "ProximityTriggers.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+auto GetResidentMegabytes() -> double
+{
+#ifdef _WIN32
+    auto counters = PROCESS_MEMORY_COUNTERS{};
+    if (!::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0.0;
+
+    return static_cast<double>(counters.WorkingSetSize) / (1024.0 * 1024.0);
+#else
+    auto statm = std::ifstream{"/proc/self/statm"};
+    auto totalPages = 0ull;
+    auto residentPages = 0ull;
+    if (!(statm >> totalPages >> residentPages))
+        return 0.0;
+
+    return static_cast<double>(residentPages * static_cast<unsigned long long>(::sysconf(_SC_PAGESIZE))) / (1024.0 * 1024.0);
+#endif
+}
+
+// Ground-plane direction, so slopes don't throw off steering
+auto Flatten(const nc::Vector3& direction) -> nc::Vector3
+{
+    const auto flat = nc::Vector3{direction.x, 0.0f, direction.z};
+    const auto length = nc::Magnitude(flat);
+    return length > 0.0001f ? flat / length : nc::Vector3::Front();
+}
+} // anonymous namespace
+
+namespace game
+{
+BotDriver::BotDriver(const std::filesystem::path& metricsPath)
+    : m_metrics{metricsPath, std::ios::trunc}
+{
+    if (!m_metrics)
+        throw nc::NcError(fmt::format("Failed to open '{}' for bot metrics", metricsPath.string()));
+
+    m_metrics << "seconds,frames,avg_ms,p99_ms,max_ms,resident_mb,wins,losses\n";
+    NC_LOG_INFO(fmt::format("Bot driving, writing metrics to '{}'", metricsPath.string()));
+}
+
+auto BotDriver::Drive(nc::ecs::Ecs world, float dt) -> uint16_t
+{
+    RecordFrame(dt);
+
+    // Win and Lose end with the orchestrator going idle behind the end game menu
+    auto& orchestrator = GameplayOrchestrator::Instance();
+    const auto event = orchestrator.GetCurrentEvent();
+    if (event == Event::Win || event == Event::Lose)
+    {
+        m_ending = event;
+    }
+    else if (m_ending != Event::None && event == Event::None)
+    {
+        const auto won = m_ending == Event::Win;
+        won ? ++m_wins : ++m_losses;
+        NC_LOG_INFO(fmt::format("Bot {} a game, starting another ({} won, {} lost)", won ? "won" : "lost", m_wins, m_losses));
+        m_ending = Event::None;
+        FireEvent(Event::NewGame);
+        return 0u;
+    }
+
+    if (orchestrator.IsInCutscene())
+    {
+        // A fresh press each time, held for one frame
+        m_dialogElapsed += dt;
+        if (m_dialogElapsed < DialogInterval)
+            return 0u;
+
+        m_dialogElapsed = 0.0f;
+        return ToKeyMask(hotkey::AdvanceDialog);
+    }
+
+    const auto bus = world.GetEntityByTag(tag::VehicleFront);
+    if (!bus.Valid() || !world.Contains<CharacterController>(bus))
+        return 0u;
+
+    return Steer(world, dt);
+}
+
+auto BotDriver::Steer(nc::ecs::Ecs world, float dt) -> uint16_t
+{
+    const auto transform = GetComponentByEntityTag<nc::Transform>(world, tag::VehicleFront);
+    const auto position = transform->Position();
+    if (m_reverseRemaining > 0.0f)
+    {
+        m_reverseRemaining -= dt;
+        return static_cast<uint16_t>(ToKeyMask(hotkey::Back) | ToKeyMask(hotkey::Left));
+    }
+
+    // Story triggers come first - while any are up, they're what moves the game along
+    auto target = GetComponentByEntityTag<ProximityTriggers>(world, tag::ProximityTriggers)->FindNearest(world, position);
+    const auto isTree = !target.has_value();
+    if (isTree)
+        target = GetComponentByEntityTag<InfectedTreeIndex>(world, tag::InfectedTreeIndex)->FindNearest(position);
+
+    if (!target)
+    {
+        TrackProgress(position, false, dt);
+        return 0u;
+    }
+
+    const auto offset = *target - position;
+    const auto distance = nc::Magnitude(nc::Vector3{offset.x, 0.0f, offset.z});
+    const auto direction = ::Flatten(offset);
+    const auto forward = ::Flatten(transform->Forward());
+    const auto angle = std::atan2(forward.z * direction.x - forward.x * direction.z, nc::Dot(forward, direction)); // positive to the right
+
+    auto keys = uint16_t{0u};
+    if (angle > AimTolerance)
+        keys |= ToKeyMask(hotkey::Right);
+    else if (angle < -AimTolerance)
+        keys |= ToKeyMask(hotkey::Left);
+
+    // Triggers are driven into, trees are sprayed from a distance
+    const auto drivingForward = std::abs(angle) < DriveTolerance && (!isTree || distance > TreeStopDistance);
+    if (drivingForward)
+        keys |= ToKeyMask(hotkey::Forward);
+
+    const auto wantsSpray = isTree && distance < SprayRange && std::abs(angle) < AimTolerance;
+    m_sprayHeld = wantsSpray && !m_sprayHeld;
+    if (m_sprayHeld)
+        keys |= ToKeyMask(hotkey::Spray);
+
+    TrackProgress(position, drivingForward, dt);
+    return keys;
+}
+
+void BotDriver::TrackProgress(const nc::Vector3& position, bool drivingForward, float dt)
+{
+    if (!drivingForward || nc::SquareDistance(position, m_progressPosition) > StuckDistance * StuckDistance)
+    {
+        m_progressPosition = position;
+        m_progressElapsed = 0.0f;
+        return;
+    }
+
+    m_progressElapsed += dt;
+    if (m_progressElapsed > StuckTime)
+    {
+        m_progressElapsed = 0.0f;
+        m_reverseRemaining = ReverseTime;
+    }
+}
+
+void BotDriver::RecordFrame(float dt)
+{
+    m_frameTimes.push_back(dt * 1000.0f);
+    m_metricsElapsed += dt;
+    m_totalElapsed += static_cast<double>(dt);
+    if (m_metricsElapsed >= MetricsInterval)
+    {
+        WriteMetrics();
+        m_metricsElapsed = 0.0f;
+        m_frameTimes.clear();
+    }
+}
+
+void BotDriver::WriteMetrics()
+{
+    const auto frameCount = m_frameTimes.size();
+    const auto average = m_metricsElapsed * 1000.0f / static_cast<float>(frameCount);
+    const auto maxFrame = std::ranges::max(m_frameTimes);
+    const auto p99 = m_frameTimes.begin() + static_cast<std::ptrdiff_t>(frameCount * 99 / 100);
+    std::ranges::nth_element(m_frameTimes, p99);
+    const auto residentMb = ::GetResidentMegabytes();
+
+    m_metrics << fmt::format("{:.0f},{},{:.2f},{:.2f},{:.2f},{:.1f},{},{}\n", m_totalElapsed, frameCount, average, *p99, maxFrame, residentMb, m_wins, m_losses) << std::flush;
+    NC_LOG_INFO(fmt::format("Bot metrics: {} frames, avg {:.2f}ms, p99 {:.2f}ms, max {:.2f}ms, {:.1f}MB resident",
+                            frameCount, average, *p99, maxFrame, residentMb));
+}
+} // namespace game
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Core.h"
+#include "Event.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace game
+{
+// Plays the game unattended, for soak and load tests. It holds the same keys a player would, through GameInput. Each
+// frame it steers the bus at a target: the nearest story trigger, or once the spread starts, the nearest infected
+// tree, which it sprays once lined up and in range. Cutscene dialog is skipped through, and a new game is started
+// whenever one ends, so it can run indefinitely. There's no navigation data for the level, so it drives straight at
+// targets, and backs off and turns whenever it stops making progress.
+//
+// Frame times and memory use are appended to a csv, and logged, every MetricsInterval seconds.
+class BotDriver
+{
+    public:
+        static constexpr auto MetricsInterval = 30.0f;
+        static constexpr auto DialogInterval = 0.5f;
+        static constexpr auto SprayRange = 10.0f; // a spray from a standstill reaches 12m
+        static constexpr auto TreeStopDistance = 6.0f;
+        static constexpr auto AimTolerance = 0.15f; // radians
+        static constexpr auto DriveTolerance = 1.0f; // only drive forward with the target roughly ahead
+        static constexpr auto StuckTime = 2.0f;
+        static constexpr auto StuckDistance = 0.5f;
+        static constexpr auto ReverseTime = 1.5f;
+
+        explicit BotDriver(const std::filesystem::path& metricsPath);
+
+        // Returns the keys to hold this frame, as a mask of ToKeyMask bits
+        auto Drive(nc::ecs::Ecs world, float dt) -> uint16_t;
+
+    private:
+        std::ofstream m_metrics;
+        std::vector<float> m_frameTimes;
+        float m_metricsElapsed = 0.0f;
+        double m_totalElapsed = 0.0; // hours of float frame times would lose most of their precision
+        size_t m_wins = 0ull;
+        size_t m_losses = 0ull;
+        Event m_ending = Event::None;
+        float m_dialogElapsed = 0.0f;
+        bool m_sprayHeld = false;
+        nc::Vector3 m_progressPosition = nc::Vector3::Zero();
+        float m_progressElapsed = 0.0f;
+        float m_reverseRemaining = 0.0f;
+
+        auto Steer(nc::ecs::Ecs world, float dt) -> uint16_t;
+        void TrackProgress(const nc::Vector3& position, bool drivingForward, float dt);
+        void RecordFrame(float dt);
+        void WriteMetrics();
+};
+} // namespace game
@@ -0,0 +1,216 @@
+#include "ChainSolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace
+{
+struct Vector2
+{
+    float x;
+    float z;
+};
+
+// A point 'offset' along a body's forward axis
+auto AlongForward(float yaw, float offset) -> Vector2
+{
+    return Vector2{std::sin(yaw) * offset, std::cos(yaw) * offset};
+}
+
+// Velocity of a point at r from a body's center per unit of angular velocity
+auto Perpendicular(const Vector2& r) -> Vector2
+{
+    return Vector2{r.z, -r.x};
+}
+
+auto WrapAngle(float angle) -> float
+{
+    constexpr auto pi = std::numbers::pi_v<float>;
+    return angle - 2.0f * pi * std::floor((angle + pi) / (2.0f * pi));
+}
+} // anonymous namespace
+
+namespace game
+{
+ChainSolver::ChainSolver(const ChainPose& lead, const ChainSolverSettings& settings)
+    : m_settings{settings}
+{
+    // The lead is driven, so it's immovable as far as the hitches are concerned
+    m_bodies.push_back(Body{lead.x, lead.z, lead.yaw, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, ChainMotion{}});
+}
+
+void ChainSolver::AddCar(float mass, float width, float length, float leadOffset, float followOffset)
+{
+    const auto& last = m_bodies.back();
+    const auto back = ::AlongForward(last.yaw, -(leadOffset + followOffset));
+    const auto inertia = mass * (width * width + length * length) / 12.0f;
+    m_bodies.push_back(Body{last.x + back.x, last.z + back.z, last.yaw, 0.0f, 0.0f, 0.0f, 1.0f / mass, 1.0f / inertia, ChainMotion{}});
+    m_hitches.push_back(Hitch{leadOffset, followOffset, 0.0f, 0.0f});
+}
+
+void ChainSolver::Step(const ChainPose& lead, float dt)
+{
+    const auto substeps = std::max(m_settings.substeps, 1u);
+    const auto substepDt = dt / static_cast<float>(substeps);
+    const auto linearDamping = 1.0f / (1.0f + substepDt * m_settings.linearDamping);
+    const auto angularDamping = 1.0f / (1.0f + substepDt * m_settings.angularDamping);
+
+    auto& driven = m_bodies.front();
+    const auto from = ChainPose{driven.x, driven.z, driven.yaw};
+    const auto turn = ::WrapAngle(lead.yaw - from.yaw);
+    driven.velocityX = (lead.x - from.x) / dt;
+    driven.velocityZ = (lead.z - from.z) / dt;
+    driven.angularVelocity = turn / dt;
+    for (auto& body : m_bodies)
+    {
+        body.impulse = ChainMotion{};
+    }
+
+    for (auto substep = 1u; substep <= substeps; ++substep)
+    {
+        for (auto body = 1ull; body < m_bodies.size(); ++body)
+        {
+            auto& car = m_bodies[body];
+            car.velocityX *= linearDamping;
+            car.velocityZ *= linearDamping;
+            car.angularVelocity *= angularDamping;
+        }
+
+        // Start from the impulses that held the chain together last substep, then correct them
+        for (auto hitch = 0ull; hitch < m_hitches.size(); ++hitch)
+        {
+            auto& impulse = m_hitches[hitch];
+            if (m_settings.warmStart)
+            {
+                ApplyImpulse(hitch, impulse.impulseX, impulse.impulseZ);
+            }
+            else
+            {
+                impulse.impulseX = 0.0f;
+                impulse.impulseZ = 0.0f;
+            }
+        }
+
+        for (auto iteration = 0u; iteration < m_settings.iterations; ++iteration)
+        {
+            for (auto hitch = 0ull; hitch < m_hitches.size(); ++hitch)
+            {
+                Solve(hitch, substepDt);
+            }
+        }
+
+        for (auto body = 1ull; body < m_bodies.size(); ++body)
+        {
+            auto& car = m_bodies[body];
+            car.x += car.velocityX * substepDt;
+            car.z += car.velocityZ * substepDt;
+            car.yaw = ::WrapAngle(car.yaw + car.angularVelocity * substepDt);
+        }
+
+        const auto t = static_cast<float>(substep) / static_cast<float>(substeps);
+        driven.x = from.x + (lead.x - from.x) * t;
+        driven.z = from.z + (lead.z - from.z) * t;
+        driven.yaw = ::WrapAngle(from.yaw + turn * t);
+    }
+
+    m_maxSeparation = 0.0f;
+    for (auto hitch = 0ull; hitch < m_hitches.size(); ++hitch)
+    {
+        m_maxSeparation = std::max(m_maxSeparation, Separation(hitch));
+    }
+}
+
+auto ChainSolver::GetPose(size_t body) const -> ChainPose
+{
+    const auto& b = m_bodies[body];
+    return ChainPose{b.x, b.z, b.yaw};
+}
+
+void ChainSolver::SetState(size_t body, const ChainPose& pose, const ChainMotion& velocity)
+{
+    auto& car = m_bodies[body];
+    car.x = pose.x;
+    car.z = pose.z;
+    car.yaw = pose.yaw;
+    car.velocityX = velocity.x;
+    car.velocityZ = velocity.z;
+    car.angularVelocity = velocity.angular;
+}
+
+auto ChainSolver::GetImpulse(size_t body) const -> ChainMotion
+{
+    return m_bodies[body].impulse;
+}
+
+void ChainSolver::ApplyImpulse(size_t hitch, float impulseX, float impulseZ)
+{
+    auto& lead = m_bodies[hitch];
+    auto& follow = m_bodies[hitch + 1];
+    const auto leadArm = ::Perpendicular(::AlongForward(lead.yaw, -m_hitches[hitch].leadOffset));
+    const auto followArm = ::Perpendicular(::AlongForward(follow.yaw, m_hitches[hitch].followOffset));
+
+    const auto leadAngular = leadArm.x * impulseX + leadArm.z * impulseZ;
+    const auto followAngular = followArm.x * impulseX + followArm.z * impulseZ;
+
+    lead.velocityX += lead.inverseMass * impulseX;
+    lead.velocityZ += lead.inverseMass * impulseZ;
+    lead.angularVelocity += lead.inverseInertia * leadAngular;
+    follow.velocityX -= follow.inverseMass * impulseX;
+    follow.velocityZ -= follow.inverseMass * impulseZ;
+    follow.angularVelocity -= follow.inverseInertia * followAngular;
+
+    lead.impulse.x += impulseX;
+    lead.impulse.z += impulseZ;
+    lead.impulse.angular += leadAngular;
+    follow.impulse.x -= impulseX;
+    follow.impulse.z -= impulseZ;
+    follow.impulse.angular -= followAngular;
+}
+
+void ChainSolver::Solve(size_t hitch, float substepDt)
+{
+    const auto& lead = m_bodies[hitch];
+    const auto& follow = m_bodies[hitch + 1];
+    const auto leadR = ::AlongForward(lead.yaw, -m_hitches[hitch].leadOffset);
+    const auto followR = ::AlongForward(follow.yaw, m_hitches[hitch].followOffset);
+    const auto leadArm = ::Perpendicular(leadR);
+    const auto followArm = ::Perpendicular(followR);
+
+    // Separation of the two sides of the hitch, and how fast it's changing
+    const auto errorX = (lead.x + leadR.x) - (follow.x + followR.x);
+    const auto errorZ = (lead.z + leadR.z) - (follow.z + followR.z);
+    const auto rateX = (lead.velocityX + lead.angularVelocity * leadArm.x) - (follow.velocityX + follow.angularVelocity * followArm.x);
+    const auto rateZ = (lead.velocityZ + lead.angularVelocity * leadArm.z) - (follow.velocityZ + follow.angularVelocity * followArm.z);
+
+    // Effective mass of the hitch, as a symmetric 2x2 matrix
+    const auto inverseMass = lead.inverseMass + follow.inverseMass;
+    const auto softness = m_settings.softness;
+    const auto kxx = softness + inverseMass + lead.inverseInertia * leadArm.x * leadArm.x + follow.inverseInertia * followArm.x * followArm.x;
+    const auto kxz = lead.inverseInertia * leadArm.x * leadArm.z + follow.inverseInertia * followArm.x * followArm.z;
+    const auto kzz = softness + inverseMass + lead.inverseInertia * leadArm.z * leadArm.z + follow.inverseInertia * followArm.z * followArm.z;
+    const auto determinant = kxx * kzz - kxz * kxz;
+    if (determinant <= 0.0f)
+        return;
+
+    const auto biasScale = m_settings.bias / substepDt;
+    const auto& accumulated = m_hitches[hitch];
+    const auto targetX = -(rateX + biasScale * errorX + softness * accumulated.impulseX);
+    const auto targetZ = -(rateZ + biasScale * errorZ + softness * accumulated.impulseZ);
+    const auto impulseX = (kzz * targetX - kxz * targetZ) / determinant;
+    const auto impulseZ = (kxx * targetZ - kxz * targetX) / determinant;
+
+    m_hitches[hitch].impulseX += impulseX;
+    m_hitches[hitch].impulseZ += impulseZ;
+    ApplyImpulse(hitch, impulseX, impulseZ);
+}
+
+auto ChainSolver::Separation(size_t hitch) const -> float
+{
+    const auto& lead = m_bodies[hitch];
+    const auto& follow = m_bodies[hitch + 1];
+    const auto leadR = ::AlongForward(lead.yaw, -m_hitches[hitch].leadOffset);
+    const auto followR = ::AlongForward(follow.yaw, m_hitches[hitch].followOffset);
+    return std::hypot((lead.x + leadR.x) - (follow.x + followR.x), (lead.z + leadR.z) - (follow.z + followR.z));
+}
+} // namespace game
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// No engine dependencies in here - this is shared with the vehicle-bench tool
+
+namespace game
+{
+// Position and heading on the ground plane. Yaw is about +y, with zero facing +z.
+struct ChainPose
+{
+    float x;
+    float z;
+    float yaw;
+};
+
+// Linear and angular parts on the ground plane, either a velocity or an impulse
+struct ChainMotion
+{
+    float x;
+    float z;
+    float angular;
+};
+
+struct ChainSolverSettings
+{
+    unsigned substeps = 2;
+    unsigned iterations = 1;     // passes over the hitches each substep
+    float bias = 0.2f;           // fraction of a hitch's separation corrected each substep
+    float softness = 0.0f;       // lets a hitch give under load, like NcPhysics joints
+    float linearDamping = 0.9f;  // per second
+    float angularDamping = 0.9f;
+    bool warmStart = true; // holds the chain at 2 substeps in vehicle-bench, where it needs 4 without
+};
+
+// Articulated chain on the ground plane: a lead body that's driven from outside, followed by cars that are each
+// pinned to the body ahead by a hitch. Hitches are solved as one system with sequential impulses over several
+// substeps, so the pull from the lead reaches the back of the chain within a few substeps rather than a few frames.
+class ChainSolver
+{
+    public:
+        explicit ChainSolver(const ChainPose& lead, const ChainSolverSettings& settings = {});
+
+        // Adds a car behind the last body, facing the same way, with the hitch 'leadOffset' behind the last body's
+        // center and 'followOffset' in front of the new car's
+        void AddCar(float mass, float width, float length, float leadOffset, float followOffset);
+
+        // Moves the lead to 'lead' over dt and brings the cars along
+        void Step(const ChainPose& lead, float dt);
+
+        auto GetPose(size_t body) const -> ChainPose; // body 0 is the lead
+
+        // Moves a car to where something else put it and how fast it's going there
+        void SetState(size_t body, const ChainPose& pose, const ChainMotion& velocity);
+
+        // Total impulse the hitches put on a body over the last step
+        auto GetImpulse(size_t body) const -> ChainMotion;
+        auto GetBodyCount() const noexcept { return m_bodies.size(); }
+
+        // Largest distance between the two sides of any hitch after the last step
+        auto GetMaxSeparation() const noexcept { return m_maxSeparation; }
+
+    private:
+        struct Body
+        {
+            float x, z, yaw;
+            float velocityX, velocityZ, angularVelocity;
+            float inverseMass, inverseInertia;
+            ChainMotion impulse;
+        };
+
+        struct Hitch
+        {
+            float leadOffset;   // behind the leading body's center
+            float followOffset; // in front of the following body's center
+            float impulseX, impulseZ;
+        };
+
+        ChainSolverSettings m_settings;
+        std::vector<Body> m_bodies;
+        std::vector<Hitch> m_hitches;
+        float m_maxSeparation = 0.0f;
+
+        void ApplyImpulse(size_t hitch, float impulseX, float impulseZ);
+        void Solve(size_t hitch, float substepDt);
+        auto Separation(size_t hitch) const -> float;
+};
+} // namespace game
@@ -1,6 +1,13 @@
 #include "Character.h"
 #include "Assets.h"
 #include "Core.h"
+#include "GameInput.h"
+#include "ParticleBudget.h"
+#include "Tree.h"
+#include "VoiceManager.h"
+
+#include <cmath>
+#include <numbers>
 
 namespace
 {
@@ -40,6 +47,13 @@ auto CreateVehicleNode(nc::ecs::Ecs world,
     return node;
 }
 
+auto GetGroundPose(const nc::Transform& transform) -> game::ChainPose
+{
+    const auto position = transform.Position();
+    const auto forward = transform.Forward();
+    return game::ChainPose{position.x, position.z, std::atan2(forward.x, forward.z)};
+}
+
 auto CreateVehicle(nc::ecs::Ecs world, nc::physics::NcPhysics* phys, const nc::Vector3& position) -> nc::Entity
 {
     constexpr auto frontMass = 15.0f;
@@ -58,12 +72,24 @@ auto CreateVehicle(nc::ecs::Ecs world, nc::physics::NcPhysics* phys, const nc::V
     const auto third = CreateVehicleNode(world, position - nc::Vector3{0.0f, -0.1f, 2.88f}, nc::Vector3::Splat(0.6f), game::tag::VehicleCar, game::layer::BoxCar, game::BusCarMesh, game::BusCarMaterial, car2Mass, car2Friction);
     const auto fourth = CreateVehicleNode(world, position - nc::Vector3{0.0f, -0.1f, 3.78f}, nc::Vector3::Splat(0.4f), game::tag::VehicleCar, game::layer::BoxCar, game::BusCarMesh, game::BusCarMaterial, car3Mass, car3Friction);
 
-    // TODO: play with these values
-    constexpr auto bias = 0.3f; // lower has more 'spring', too high propagates too much force to front car
-    constexpr auto softness = 0.4f; // maybe lower?
-    phys->AddJoint(head, second, nc::Vector3{0.0f, -0.1f, -1.08f}, nc::Vector3{0.0f, 0.0f, 0.9f}, bias, softness);
-    phys->AddJoint(second, third, nc::Vector3{0.0f, -0.1f, -0.9f}, nc::Vector3{0.0f, 0.0f, 0.72f}, bias * 2.0f, softness);
-    phys->AddJoint(third, fourth, nc::Vector3{0.0f, -0.1f, -0.72f}, nc::Vector3{0.0f, 0.0f, 0.54f}, bias * 2.0f, softness);
+    if constexpr (!game::UseChainSolver)
+    {
+        // TODO: play with these values
+        constexpr auto bias = 0.3f; // lower has more 'spring', too high propagates too much force to front car
+        constexpr auto softness = 0.4f; // maybe lower?
+        phys->AddJoint(head, second, nc::Vector3{0.0f, -0.1f, -1.08f}, nc::Vector3{0.0f, 0.0f, 0.9f}, bias, softness);
+        phys->AddJoint(second, third, nc::Vector3{0.0f, -0.1f, -0.9f}, nc::Vector3{0.0f, 0.0f, 0.72f}, bias * 2.0f, softness);
+        phys->AddJoint(third, fourth, nc::Vector3{0.0f, -0.1f, -0.72f}, nc::Vector3{0.0f, 0.0f, 0.54f}, bias * 2.0f, softness);
+        return head;
+    }
+
+    // Hitches split each gap in proportion to the car lengths - vehicle-bench drives this same train
+    const auto chain = world.Emplace<nc::Entity>({.tag = "VehicleChain", .flags = nc::Entity::Flags::NoSerialize});
+    auto solver = world.Emplace<game::VehicleChain>(chain, head, *world.Get<nc::Transform>(head));
+    solver->AddCar(second, *world.Get<nc::Transform>(second), car1Mass, 0.8f, 0.9f, 0.72f);
+    solver->AddCar(third, *world.Get<nc::Transform>(third), car2Mass, 0.6f, 0.72f, 0.54f);
+    solver->AddCar(fourth, *world.Get<nc::Transform>(fourth), car3Mass, 0.4f, 0.54f, 0.36f);
+    world.Emplace<nc::FixedLogic>(chain, nc::InvokeFreeComponent<game::VehicleChain>{});
 
     return head;
 }
@@ -71,7 +97,7 @@ auto CreateVehicle(nc::ecs::Ecs world, nc::physics::NcPhysics* phys, const nc::V
 
 namespace game
 {
-auto CreateCharacter(nc::ecs::Ecs world, nc::physics::NcPhysics* phys, const nc::Vector3& position) -> nc::Entity
+auto CreateCharacter(nc::ecs::Ecs world, nc::physics::NcPhysics* phys, VoiceManager* voices, const nc::Vector3& position) -> nc::Entity
 {
     const auto character = ::CreateVehicle(world, phys, position);
 
@@ -85,7 +111,7 @@ auto CreateCharacter(nc::ecs::Ecs world, nc::physics::NcPhysics* phys, const nc:
 
     const auto characterAudio = world.Emplace<nc::Entity>({.parent = character, .tag = tag::VehicleAudio});
     auto p = world.Emplace<CharacterAudio>(characterAudio, character);
-    p->Init(world);
+    p->Init(world, voices);
     world.Emplace<nc::FrameLogic>(characterAudio, nc::InvokeFreeComponent<CharacterAudio>{});
 
     const auto transform = world.Get<nc::Transform>(character);
@@ -93,7 +119,7 @@ auto CreateCharacter(nc::ecs::Ecs world, nc::physics::NcPhysics* phys, const nc:
     const auto forwardMin = transform->ToLocalSpace(nc::Vector3{-1.0f, -1.0f, 5.0f}) * 5.0f;
     const auto forwardMax = transform->ToLocalSpace(nc::Vector3{-1.0f, -1.0f, 10.0f}) * 10.0f;
 
-    const auto purifyParticles = world.Emplace<nc::Entity>({.parent = character, .tag = "PurifyParticles"});
+    const auto purifyParticles = world.Emplace<nc::Entity>({.parent = character, .tag = tag::PurifyParticles});
     world.Emplace<nc::graphics::ParticleEmitter>(purifyParticles, nc::graphics::ParticleInfo{
         .init = nc::graphics::ParticleInitInfo{
             .lifetime = 1.0f,
@@ -117,21 +143,29 @@ auto CreateCharacter(nc::ecs::Ecs world, nc::physics::NcPhysics* phys, const nc:
     return character;
 }
 
-void CharacterController::SetAudioState(nc::Registry* registry, VehicleState state)
+void CharacterController::Resolve(nc::Registry* registry)
 {
-    auto characterAudio = GetComponentByEntityTag<CharacterAudio>(registry, tag::VehicleAudio);
-    characterAudio->SetState(state);
+    auto world = registry->GetEcs();
+    if (!m_audio.Valid() || !registry->Contains<CharacterAudio>(m_audio))
+        m_audio = world.GetEntityByTag(tag::VehicleAudio);
+
+    if (!m_particleBudget.Valid() || !registry->Contains<ParticleBudget>(m_particleBudget))
+        m_particleBudget = world.GetEntityByTag(tag::ParticleBudget);
+
+    if (!m_infectedTrees.Valid() || !registry->Contains<InfectedTreeIndex>(m_infectedTrees))
+        m_infectedTrees = world.GetEntityByTag(tag::InfectedTreeIndex);
+
+    if (!m_purifyParticles.Valid() || !registry->Contains<nc::graphics::ParticleEmitter>(m_purifyParticles))
+        m_purifyParticles = world.GetEntityByTag(tag::PurifyParticles);
 }
 
 void CharacterController::Run(nc::Entity self, nc::Registry* registry)
 {
     static auto fixedDt = nc::config::GetPhysicsSettings().fixedUpdateInterval;
 
-    auto* body = registry->Get<nc::physics::PhysicsBody>(self);
+    Resolve(registry);
     auto* transform = registry->Get<nc::Transform>(self);
-
-    if(!body || !transform)
-        return;
+    auto* audio = registry->Get<CharacterAudio>(m_audio);
 
     if (m_lungeOnCooldown)
     {
@@ -150,22 +184,22 @@ void CharacterController::Run(nc::Entity self, nc::Registry* registry)
         {
             m_sprayRemainingCooldownTime = 0.0f;
             m_sprayOnCooldown = false;
-            registry->Remove<nc::Entity>(m_purifier);
-            m_purifier = nc::Entity::Null();
         }
+
+        PurifySprayedTrees(registry);
     }
 
-    if (KeyDown(game::hotkey::Forward))
+    if (input::KeyDown(game::hotkey::Forward))
     {
-        SetAudioState(registry, VehicleState::StartForward);
+        audio->SetState(VehicleState::StartForward);
     }
-    else if (KeyUp(game::hotkey::Forward))
+    else if (input::KeyUp(game::hotkey::Forward))
     {
-        SetAudioState(registry, VehicleState::StopForward);
+        audio->SetState(VehicleState::StopForward);
     }
 
     auto moving = false;
-    if (KeyHeld(game::hotkey::Forward))
+    if (input::KeyHeld(game::hotkey::Forward))
     {
         moving = true;
 
@@ -183,7 +217,7 @@ void CharacterController::Run(nc::Entity self, nc::Registry* registry)
             }
             else
             {
-                SetAudioState(registry, VehicleState::StopForward);
+                audio->SetState(VehicleState::StopForward);
                 m_inchDecelerating = true;
                 m_timeAtMoveBound = 0.0f;
             }
@@ -200,7 +234,7 @@ void CharacterController::Run(nc::Entity self, nc::Registry* registry)
             }
             else
             {
-                SetAudioState(registry, VehicleState::Forward);
+                audio->SetState(VehicleState::Forward);
                 m_inchDecelerating = false;
                 m_timeAtMoveBound = 0.0f;
             }
@@ -223,18 +257,18 @@ void CharacterController::Run(nc::Entity self, nc::Registry* registry)
         }
     }
 
-    if (KeyHeld(game::hotkey::Back))
+    if (input::KeyHeld(game::hotkey::Back))
     {
-        SetAudioState(registry, VehicleState::Forward);
+        audio->SetState(VehicleState::Forward);
         transform->Translate(-transform->Forward() * moveVelocityUpperBound * 0.5f * fixedDt);
     }
-    else if (KeyUp(game::hotkey::Back))
+    else if (input::KeyUp(game::hotkey::Back))
     {
-        SetAudioState(registry, VehicleState::StopForward);
+        audio->SetState(VehicleState::StopForward);
     }
 
     auto turning = false;
-    if (KeyHeld(game::hotkey::Left))
+    if (input::KeyHeld(game::hotkey::Left))
     {
         turning = true;
         auto max = moving ? maxMovingTurnVelocity : maxStationaryTurnVelocity;
@@ -242,7 +276,7 @@ void CharacterController::Run(nc::Entity self, nc::Registry* registry)
             m_currentTurnVelocity -= turnAcceleration;
     }
 
-    if (KeyHeld(game::hotkey::Right))
+    if (input::KeyHeld(game::hotkey::Right))
     {
         turning = true;
         auto max = moving ? maxMovingTurnVelocity : maxStationaryTurnVelocity;
@@ -260,18 +294,17 @@ void CharacterController::Run(nc::Entity self, nc::Registry* registry)
         m_currentTurnVelocity = 0.0f;
     }
 
-    if (!m_lungeOnCooldown && KeyDown(game::hotkey::Lunge))
+    if (!m_lungeOnCooldown && input::KeyDown(game::hotkey::Lunge))
     {
         m_lungeOnCooldown = true;
         m_lungeRemainingCooldownTime = lungeCooldown;
     }
 
-    if (m_sprayerEquipped && !m_sprayOnCooldown && KeyDown(game::hotkey::Spray))
+    if (m_sprayerEquipped && !m_sprayOnCooldown && input::KeyDown(game::hotkey::Spray))
     {
-        auto characterAudio = GetComponentByEntityTag<CharacterAudio>(registry, tag::VehicleAudio);
-        characterAudio->PlayPurifySfx(registry->GetEcs());
+        audio->PlayPurifySfx();
 
-        auto purifyParticles = GetComponentByEntityTag<nc::graphics::ParticleEmitter>(registry, "PurifyParticles");
+        auto purifyParticles = registry->Get<nc::graphics::ParticleEmitter>(m_purifyParticles);
         auto props = purifyParticles->GetInfo();
         const auto moveVel = transform->ToLocalSpace(nc::Vector3::Front()) * m_currentMoveVelocity;
         const auto baseVelMin = transform->ToLocalSpace(nc::Vector3{-1.0f, -1.0f, 5.0f}) * 5.0f;
@@ -279,38 +312,78 @@ void CharacterController::Run(nc::Entity self, nc::Registry* registry)
         props.kinematic.velocityMin = moveVel + baseVelMin;
         props.kinematic.velocityMax = moveVel + baseVelMax;
         purifyParticles->SetInfo(props);
-        purifyParticles->Emit(30);
-        CreatePurifier(registry, m_currentMoveVelocity);
+        purifyParticles->Emit(registry->Get<ParticleBudget>(m_particleBudget)->RequestBurst(ParticleImportance::Critical, 30u, props.init.lifetime, transform->Position()));
+        Spray(*transform, m_currentMoveVelocity);
     }
 }
 
-void CharacterController::CreatePurifier(nc::Registry* registry, float moveVelocity)
+void CharacterController::Spray(const nc::Transform& transform, float moveVelocity)
 {
     m_sprayOnCooldown = true;
     m_sprayRemainingCooldownTime = sprayCooldown;
-    const auto transform = registry->Get<nc::Transform>(ParentEntity());
-    const auto forward = transform->Forward();
 
-    m_purifier = registry->Add<nc::Entity>(
+    // The spray travels ahead of the vehicle for the length of the cooldown. Its path is fixed here, but what's on it
+    // isn't - trees can be infected while it's in flight - so each tick only sweeps the stretch covered since the last.
+    const auto forward = transform.Forward();
+    m_sprayStart = transform.Position() + forward * 2.0f;
+    m_sprayEnd = m_sprayStart + forward * (spraySpeed + moveVelocity) * sprayCooldown;
+    m_sprayReached = 0.0f;
+}
+
+void CharacterController::PurifySprayedTrees(nc::Registry* registry)
+{
+    const auto reached = 1.0f - m_sprayRemainingCooldownTime / sprayCooldown;
+    const auto path = m_sprayEnd - m_sprayStart;
+    const auto from = m_sprayStart + path * m_sprayReached;
+    const auto to = m_sprayStart + path * reached;
+    m_sprayReached = reached;
+    registry->Get<InfectedTreeIndex>(m_infectedTrees)->SweepSphere(from, to, sprayRadius, m_sprayHits);
+    for (const auto& hit : m_sprayHits)
     {
-        .position = transform->Position() + forward * 2.0f,
-        .rotation = transform->Rotation(),
-        .tag = tag::Purifier,
-        .layer = layer::Purifier,
-        .flags = nc::Entity::Flags::NoSerialize | nc::Entity::Flags::Static // absolutely should not have to make static, but is interacting with concaves...
-    });
+        // A tree can't be purified twice, but check anyway in case something else replaced it
+        if (registry->Contains<InfectedTree>(hit.tree))
+            MorphTreeToHealthy(registry->GetEcs(), hit.tree);
+    }
+}
 
-    registry->Add<nc::physics::Collider>(m_purifier, nc::physics::SphereProperties{.radius = 2.5f}, true);
-    registry->Add<nc::physics::PhysicsBody>(m_purifier, nc::physics::PhysicsProperties{.isKinematic = true});
+VehicleChain::VehicleChain(nc::Entity self, nc::Entity head, const nc::Transform& headTransform)
+    : nc::FreeComponent{self},
+      m_solver{::GetGroundPose(headTransform)},
+      m_head{head}
+{
+}
 
-    // add for debug visibility, could maybe add something?
-    // registry->Add<nc::graphics::ToonRenderer>(m_purifier, nc::asset::SphereMesh);
+void VehicleChain::AddCar(nc::Entity car, const nc::Transform& transform, float mass, float scale, float leadOffset, float followOffset)
+{
+    // Car colliders are 2x2x4 boxes at half scale
+    m_solver.AddCar(mass, scale, scale * 2.0f, leadOffset, followOffset);
+    m_cars.push_back(car);
+    m_lastPoses.push_back(::GetGroundPose(transform));
+}
 
-    registry->Add<nc::FrameLogic>(m_purifier, [moveVelocity](nc::Entity self, nc::Registry* registry, float dt)
+void VehicleChain::Run(nc::Entity, nc::Registry* registry)
+{
+    static auto fixedDt = nc::config::GetPhysicsSettings().fixedUpdateInterval;
+
+    // Start from wherever physics left the cars, moving the way it moved them
+    for (auto i = 0ull; i < m_cars.size(); ++i)
     {
-        auto transform = registry->Get<nc::Transform>(self);
-        transform->TranslateLocalSpace(nc::Vector3::Front() * 10.0f * dt + nc::Vector3::Front() * moveVelocity * dt);
-    });
+        const auto pose = ::GetGroundPose(*registry->Get<nc::Transform>(m_cars[i]));
+        const auto& last = m_lastPoses[i];
+        const auto turn = std::remainder(pose.yaw - last.yaw, 2.0f * std::numbers::pi_v<float>);
+        m_solver.SetState(i + 1, pose, ChainMotion{(pose.x - last.x) / fixedDt, (pose.z - last.z) / fixedDt, turn / fixedDt});
+        m_lastPoses[i] = pose;
+    }
+
+    // Only the hitches' pull goes to the bodies - physics integrates it along with everything else acting on them
+    m_solver.Step(::GetGroundPose(*registry->Get<nc::Transform>(m_head)), fixedDt);
+    for (auto i = 0ull; i < m_cars.size(); ++i)
+    {
+        const auto impulse = m_solver.GetImpulse(i + 1);
+        auto body = registry->Get<nc::physics::PhysicsBody>(m_cars[i]);
+        body->ApplyImpulse(nc::Vector3{impulse.x, 0.0f, impulse.z});
+        body->ApplyTorqueImpulse(nc::Vector3{0.0f, impulse.angular, 0.0f});
+    }
 }
 
 CharacterAudio::CharacterAudio(nc::Entity self, nc::Entity)
@@ -318,8 +391,9 @@ CharacterAudio::CharacterAudio(nc::Entity self, nc::Entity)
 {
 }
 
-void CharacterAudio::Init(nc::ecs::Ecs world)
+void CharacterAudio::Init(nc::ecs::Ecs world, VoiceManager* voices)
 {
+    m_voices = voices;
     constexpr auto innerRadius = 1.0f;
     constexpr auto outerRadius = 20.0f;
     const auto self = ParentEntity();
@@ -357,44 +431,36 @@ void CharacterAudio::Init(nc::ecs::Ecs world)
     });
 }
 
-void CharacterAudio::PlayPurifySfx(nc::ecs::Ecs world)
+void CharacterAudio::PlayPurifySfx()
 {
-    auto player = world.Get<nc::audio::AudioSource>(m_purifyPlayer);
-    NC_ASSERT(player, "No AudioSource");
-    player->Play();
+    m_voices->Play(m_purifyPlayer);
 }
 
-void CharacterAudio::Run(nc::Entity, nc::Registry* registry, float)
+void CharacterAudio::Run(nc::Entity, nc::Registry*, float)
 {
     if (m_currentState != m_nextState)
     {
         if (m_currentEnginePlayer.Valid())
-        {
-            auto player = registry->Get<nc::audio::AudioSource>(m_currentEnginePlayer);
-            if (player->IsPlaying()) player->Stop();
-        }
+            m_voices->Stop(m_currentEnginePlayer);
 
         switch (m_nextState)
         {
             case VehicleState::StartForward:
             {
                 m_currentEnginePlayer = m_engineStartPlayer;
-                auto player = registry->Get<nc::audio::AudioSource>(m_currentEnginePlayer);
-                player->Play();
+                m_voices->Play(m_currentEnginePlayer);
                 break;
             }
             case VehicleState::Forward:
             {
                 m_currentEnginePlayer = m_engineRunningPlayer;
-                auto player = registry->Get<nc::audio::AudioSource>(m_currentEnginePlayer);
-                player->Play();
+                m_voices->Play(m_currentEnginePlayer);
                 break;
             }
             case VehicleState::StopForward:
             {
                 m_currentEnginePlayer = m_engineStopPlayer;
-                auto player = registry->Get<nc::audio::AudioSource>(m_currentEnginePlayer);
-                player->Play();
+                m_voices->Play(m_currentEnginePlayer);
                 break;
             }
             default: break;
@@ -408,14 +474,12 @@ void CharacterAudio::Run(nc::Entity, nc::Registry* registry, float)
     {
         case VehicleState::StartForward:
         {
-            auto player = registry->Get<nc::audio::AudioSource>(m_engineStartPlayer);
-            if (!player->IsPlaying()) SetState(VehicleState::Forward);
+            if (!m_voices->IsPlaying(m_engineStartPlayer)) SetState(VehicleState::Forward);
             break;
         }
         case VehicleState::StopForward:
         {
-            auto player = registry->Get<nc::audio::AudioSource>(m_engineStopPlayer);
-            if (!player->IsPlaying()) SetState(VehicleState::Idle);
+            if (!m_voices->IsPlaying(m_engineStopPlayer)) SetState(VehicleState::Idle);
             break;
         }
         default: break;
@@ -1,10 +1,14 @@
 #pragma once
 
+#include "ChainSolver.h"
 #include "Core.h"
+#include "InfectedTreeIndex.h"
 
 namespace game
 {
-auto CreateCharacter(nc::ecs::Ecs world, nc::physics::NcPhysics* phys, const nc::Vector3& position) -> nc::Entity;
+class VoiceManager;
+
+auto CreateCharacter(nc::ecs::Ecs world, nc::physics::NcPhysics* phys, VoiceManager* voices, const nc::Vector3& position) -> nc::Entity;
 
 enum class VehicleState
 {
@@ -31,6 +35,8 @@ class CharacterController : public nc::FreeComponent
 
         static constexpr auto lungeCooldown = 0.35f;
         static constexpr auto sprayCooldown = 1.0f;
+        static constexpr auto sprayRadius = 2.5f;
+        static constexpr auto spraySpeed = 10.0f; // on top of the vehicle's speed
 
         CharacterController(nc::Entity self)
             : nc::FreeComponent{self} {}
@@ -40,7 +46,16 @@ class CharacterController : public nc::FreeComponent
         void EquipSprayer() { m_sprayerEquipped = true; }
 
     private:
-        nc::Entity m_purifier = nc::Entity::Null();
+        // Looked up by tag once, then again only if the entity is gone. The budget and tree index are scene systems, so
+        // reloading or patching the scene can replace them out from under the controller.
+        nc::Entity m_audio = nc::Entity::Null();
+        nc::Entity m_particleBudget = nc::Entity::Null();
+        nc::Entity m_infectedTrees = nc::Entity::Null();
+        nc::Entity m_purifyParticles = nc::Entity::Null();
+        std::vector<SweepHit> m_sprayHits; // scratch for the stretch of the spray's path covered each tick
+        nc::Vector3 m_sprayStart = nc::Vector3::Zero();
+        nc::Vector3 m_sprayEnd = nc::Vector3::Zero();
+        float m_sprayReached = 0.0f; // fraction of the path the spray has covered
         float m_currentMoveVelocity = 0.0f;
         float m_timeAtMoveBound = 0.0f;
         float m_currentTurnVelocity = 0.0f;
@@ -51,8 +66,30 @@ class CharacterController : public nc::FreeComponent
         bool m_sprayOnCooldown = false;
         bool m_sprayerEquipped = false;
 
-        void CreatePurifier(nc::Registry* registry, float moveVelocity);
-        void SetAudioState(nc::Registry* registry, VehicleState state);
+        void Resolve(nc::Registry* registry);
+        void Spray(const nc::Transform& transform, float moveVelocity);
+        void PurifySprayedTrees(nc::Registry* registry);
+};
+
+// Pulls the cars behind the vehicle's front with a ChainSolver, from inside the fixed step. The cars stay dynamic
+// bodies, the same as the front: the hitch impulses are handed to their PhysicsBody and physics moves them, so trees
+// and the level still push them out and the next step starts from wherever they ended up. Their height is left to
+// physics.
+class VehicleChain : public nc::FreeComponent
+{
+    public:
+        VehicleChain(nc::Entity self, nc::Entity head, const nc::Transform& headTransform);
+
+        // Cars are added front to back. Offsets place the hitch behind the car ahead and in front of this one.
+        void AddCar(nc::Entity car, const nc::Transform& transform, float mass, float scale, float leadOffset, float followOffset);
+
+        void Run(nc::Entity self, nc::Registry* registry);
+
+    private:
+        ChainSolver m_solver;
+        nc::Entity m_head;
+        std::vector<nc::Entity> m_cars;
+        std::vector<ChainPose> m_lastPoses; // where each car was a step ago, for its velocity
 };
 
 class CharacterAudio : public nc::FreeComponent
@@ -60,12 +97,13 @@ class CharacterAudio : public nc::FreeComponent
     public:
         CharacterAudio(nc::Entity self, nc::Entity character);
 
-        void Init(nc::ecs::Ecs world);
+        void Init(nc::ecs::Ecs world, VoiceManager* voices);
         void Run(nc::Entity self, nc::Registry* registry, float);
         void SetState(VehicleState state);
-        void PlayPurifySfx(nc::ecs::Ecs world);
+        void PlayPurifySfx();
 
     private:
+        VoiceManager* m_voices = nullptr;
         VehicleState m_currentState = VehicleState::Idle;
         VehicleState m_nextState = VehicleState::Idle;
         nc::Entity m_engineStartPlayer;
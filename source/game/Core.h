@@ -25,7 +25,10 @@
 #include "ncengine/physics/PhysicsBody.h"
 #include "ncengine/scene/Scene.h"
 
+#include <algorithm>
+#include <array>
 #include <string_view>
+#include <utility>
 
 namespace game
 {
@@ -33,6 +36,11 @@ namespace game
 // DO NOT SAVE SCENES WITH GAMEPLAY ENABLED!
 constexpr auto EnableGameplay = true;
 
+// Move the vehicle's cars with ChainSolver instead of engine joints. Off until the two have been profiled in-engine:
+// vehicle-bench only times ChainSolver on its own, against a ChainSolver set up like the joints, and doesn't go through
+// the engine's bodies the way VehicleChain does.
+constexpr auto UseChainSolver = false;
+
 namespace layer
 {
 // IMPORTANT! Do not change layer values, else serialized work will be garbage!
@@ -63,6 +71,7 @@ constexpr uint8_t TerrainInlet1 = 110;
 
 constexpr uint8_t TerrainCurve1 = 121;
 constexpr uint8_t TerrainCurve2 = 120;
+
 } // namespace layer
 
 namespace hotkey
@@ -77,10 +86,13 @@ constexpr auto Spray = nc::input::KeyCode::LeftShift;
 
 // General Controls
 constexpr auto ToggleMenu = nc::input::KeyCode::Escape;
+constexpr auto AdvanceDialog = nc::input::KeyCode::Space;
 
 // Debug Controls
 constexpr auto ToggleDebugCamera = nc::input::KeyCode::F5;
 constexpr auto SaveFoliageScene = nc::input::KeyCode::F9;
+constexpr auto SaveScenePatch = nc::input::KeyCode::F10;
+constexpr auto ReloadScenePatch = nc::input::KeyCode::F11;
 constexpr auto SkipToSpreadEvent = nc::input::KeyCode::F12;
 } // namespace hotkey
 
@@ -99,6 +111,7 @@ const auto MainCamera = std::string{"Camera"};
 const auto VehicleFront = std::string{"VehicleFront"};
 const auto VehicleCar = std::string{"BoxCar"};
 const auto VehicleAudio = std::string{"VehicleAudio"};
+const auto PurifyParticles = std::string{"PurifyParticles"};
 const auto AmbienceSfx = std::string{"AmbienceSfx"};
 const auto IntroThemeMusic = std::string{"IntroThemeMusic"};
 const auto BlightClearedMusic = std::string{"BlightClearedMusic"};
@@ -132,6 +145,17 @@ const auto DaveEndingPosition = std::string{"DaveEndingPosition"};
 const auto EndingFocusPoint = std::string{"EndingFocusPoint"};
 
 const auto Light = std::string{"Light"};
+
+// Systems
+const auto VoiceManager = std::string{"VoiceManager"};
+const auto ParticleBurstPool = std::string{"ParticleBurstPool"};
+const auto ParticleBudget = std::string{"ParticleBudget"};
+const auto LightAnimator = std::string{"LightAnimator"};
+const auto LightClusterer = std::string{"LightClusterer"};
+const auto AnimationCrowd = std::string{"AnimationCrowd"};
+const auto InfectedTreeIndex = std::string{"InfectedTreeIndex"};
+const auto TriggerEventQueue = std::string{"TriggerEventQueue"};
+const auto ProximityTriggers = std::string{"ProximityTriggers"};
 } // namespace tag
 
 void LoadFragment(std::string_view path, nc::Registry* registry, nc::ModuleProvider modules);
@@ -0,0 +1,202 @@
+#include "GameInput.h"
+#include "BotDriver.h"
+
+#include <random>
+#include <utility>
+
+namespace
+{
+constexpr auto RecordingMagic = uint32_t{0x5249434e}; // 'NCIR'
+constexpr auto RecordingVersion = uint32_t{2}; // 1 recorded per frame
+
+static_assert(game::RecordedKeys.size() <= 16, "Key masks are 16 bits");
+
+template<class T>
+void Write(std::ostream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<class T>
+auto Read(std::istream& stream) -> T
+{
+    auto value = T{};
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!stream)
+        throw nc::NcError("Unexpected end of input recording");
+
+    return value;
+}
+} // anonymous namespace
+
+namespace game
+{
+auto ToKeyMask(nc::input::KeyCode key) -> uint16_t
+{
+    const auto pos = std::ranges::find(RecordedKeys, key);
+    NC_ASSERT(pos != RecordedKeys.end(), "Key isn't in RecordedKeys");
+    return static_cast<uint16_t>(1u << std::distance(RecordedKeys.begin(), pos));
+}
+
+GameInput::GameInput(InputMode mode, const std::filesystem::path& path)
+    : m_mode{mode}
+{
+    NC_ASSERT(!GameInput::m_instance, "Already a GameInput instance");
+    GameInput::m_instance = this;
+
+    if (m_mode == InputMode::Record)
+    {
+        m_recording.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_recording)
+            throw nc::NcError(fmt::format("Failed to open '{}' for recording", path.string()));
+
+        m_seed = std::random_device{}();
+        ::Write(m_recording, RecordingMagic);
+        ::Write(m_recording, RecordingVersion);
+        ::Write(m_recording, *m_seed);
+        NC_LOG_INFO(fmt::format("Recording input to '{}' with seed {}", path.string(), *m_seed));
+    }
+    else if (m_mode == InputMode::Replay)
+    {
+        auto stream = std::ifstream{path, std::ios::binary};
+        if (!stream)
+            throw nc::NcError(fmt::format("Input recording '{}' not found", path.string()));
+
+        if (::Read<uint32_t>(stream) != RecordingMagic)
+            throw nc::NcError("Invalid input recording");
+
+        if (const auto version = ::Read<uint32_t>(stream); version != RecordingVersion)
+            throw nc::NcError(fmt::format("Unsupported input recording version '{}'", version));
+
+        m_seed = ::Read<uint32_t>(stream);
+        while (stream.peek() != std::char_traits<char>::eof())
+        {
+            auto& run = m_replay.emplace_back();
+            run.keys.held = ::Read<uint16_t>(stream);
+            run.keys.down = ::Read<uint16_t>(stream);
+            run.keys.up = ::Read<uint16_t>(stream);
+            run.tickCount = ::Read<uint32_t>(stream);
+        }
+
+        NC_LOG_INFO(fmt::format("Replaying input from '{}' with seed {}", path.string(), *m_seed));
+    }
+    else if (m_mode == InputMode::Bot)
+    {
+        m_seed = BotSeed;
+        m_bot = std::make_unique<BotDriver>(path);
+    }
+}
+
+GameInput::~GameInput() noexcept
+{
+    if (m_mode == InputMode::Record && m_pending.tickCount > 0)
+        WriteRun(m_pending);
+
+    GameInput::m_instance = nullptr;
+}
+
+auto GameInput::Instance() -> GameInput&
+{
+    NC_ASSERT(GameInput::m_instance, "No GameInput instance");
+    return *GameInput::m_instance;
+}
+
+void GameInput::Latch(nc::ecs::Ecs world, float dt)
+{
+    m_frame = std::exchange(m_sinceFrame, KeyState{m_sinceFrame.held, 0, 0});
+    if (m_mode == InputMode::Replay)
+        return;
+
+    // Presses and releases stay latched until a tick takes them, even if this frame has no tick
+    if (m_mode == InputMode::Bot)
+    {
+        const auto held = m_bot->Drive(world, dt);
+        m_latched.down |= static_cast<uint16_t>(held & ~m_latched.held);
+        m_latched.up |= static_cast<uint16_t>(m_latched.held & ~held);
+        m_latched.held = held;
+        return;
+    }
+
+    m_latched.held = 0;
+    for (auto i = 0ull; i < RecordedKeys.size(); ++i)
+    {
+        const auto bit = static_cast<uint16_t>(1u << i);
+        if (nc::input::KeyHeld(RecordedKeys[i])) m_latched.held |= bit;
+        if (nc::input::KeyDown(RecordedKeys[i])) m_latched.down |= bit;
+        if (nc::input::KeyUp(RecordedKeys[i])) m_latched.up |= bit;
+    }
+}
+
+void GameInput::Tick()
+{
+    ++m_tick;
+    if (m_mode == InputMode::Replay && m_replayRun == m_replay.size())
+    {
+        NC_LOG_INFO(fmt::format("Input replay finished after {} ticks, switching to live input", m_tick - 1));
+        m_mode = InputMode::Live;
+    }
+
+    if (m_mode == InputMode::Replay)
+    {
+        const auto& run = m_replay[m_replayRun];
+        m_current = run.keys;
+        if (++m_replayTick >= run.tickCount)
+        {
+            ++m_replayRun;
+            m_replayTick = 0u;
+        }
+    }
+    else
+    {
+        m_current = std::exchange(m_latched, KeyState{m_latched.held, 0, 0});
+        if (m_mode == InputMode::Record)
+            Record(m_current);
+    }
+
+    m_sinceFrame.held = m_current.held;
+    m_sinceFrame.down |= m_current.down;
+    m_sinceFrame.up |= m_current.up;
+}
+
+auto GameInput::KeyDown(nc::input::KeyCode key) const -> bool
+{
+    return m_current.down & ToKeyMask(key);
+}
+
+auto GameInput::KeyHeld(nc::input::KeyCode key) const -> bool
+{
+    return m_current.held & ToKeyMask(key);
+}
+
+auto GameInput::KeyUp(nc::input::KeyCode key) const -> bool
+{
+    return m_current.up & ToKeyMask(key);
+}
+
+auto GameInput::FrameKeyDown(nc::input::KeyCode key) const -> bool
+{
+    return m_frame.down & ToKeyMask(key);
+}
+
+void GameInput::Record(const KeyState& keys)
+{
+    if (m_pending.tickCount > 0 && m_pending.keys == keys)
+    {
+        ++m_pending.tickCount;
+        return;
+    }
+
+    if (m_pending.tickCount > 0)
+        WriteRun(m_pending);
+
+    m_pending = Run{keys, 1u};
+}
+
+void GameInput::WriteRun(const Run& run)
+{
+    ::Write(m_recording, run.keys.held);
+    ::Write(m_recording, run.keys.down);
+    ::Write(m_recording, run.keys.up);
+    ::Write(m_recording, run.tickCount);
+}
+} // namespace game
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Core.h"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+
+namespace game
+{
+enum class InputMode : uint8_t
+{
+    Live,
+    Record, // play live, saving each fixed tick's keys
+    Replay, // play back a recording, then continue live once it runs out
+    Bot     // keys come from a BotDriver
+};
+
+// Every key gameplay reads. Recordings store a bit per key in this order, so only ever append to it.
+constexpr auto RecordedKeys = std::array{
+    hotkey::Forward,
+    hotkey::Back,
+    hotkey::Left,
+    hotkey::Right,
+    hotkey::Lunge,
+    hotkey::Spray,
+    hotkey::AdvanceDialog,
+    hotkey::ToggleMenu,
+    hotkey::SkipToSpreadEvent
+};
+
+// Bit for 'key' in recorded key masks
+auto ToKeyMask(nc::input::KeyCode key) -> uint16_t;
+
+class BotDriver;
+
+// The keyboard as gameplay sees it. Keys are latched from nc::input every frame, with presses and releases kept until
+// the next fixed tick, and each tick takes the latched keys as its own. These are either passed through, recorded to a
+// file, or replaced by a recording. Recordings also hold the seed the session was played with, so a replay generates
+// the same world and sees the same keys on the same fixed ticks, however the ticks fall into frames. Debug and editor
+// keys aren't recorded and are still read straight from nc::input. In bot mode, keys are taken from a BotDriver every
+// frame in place of nc::input, with a fixed seed.
+//
+// Fixed step code reads the current tick's keys. Per frame code reads the FrameKey queries instead, which hold every
+// press and release from the ticks since the last frame, so none are missed or seen twice whatever the frame rate.
+//
+// File layout is:
+//   magic | version | seed | {held mask, down mask, up mask, tick count}...
+// with one run per stretch of ticks with identical keys, so idle or steady driving costs next to nothing.
+class GameInput
+{
+    public:
+        static constexpr auto BotSeed = uint32_t{1u};
+
+        // 'path' is the recording to write or read, or where a bot writes its metrics
+        GameInput(InputMode mode, const std::filesystem::path& path);
+        ~GameInput() noexcept;
+
+        GameInput(const GameInput&) = delete;
+        GameInput& operator=(const GameInput&) = delete;
+
+        static auto Instance() -> GameInput&;
+
+        // The seed the scene should use, or nullopt when playing live
+        auto GetSeed() const noexcept { return m_seed; }
+        auto GetMode() const noexcept { return m_mode; }
+
+        // Called once a frame, before anything reads keys that frame
+        void Latch(nc::ecs::Ecs world, float dt);
+
+        // Called once a fixed tick, before anything reads keys that tick
+        void Tick();
+
+        auto KeyDown(nc::input::KeyCode key) const -> bool;
+        auto KeyHeld(nc::input::KeyCode key) const -> bool;
+        auto KeyUp(nc::input::KeyCode key) const -> bool;
+        auto FrameKeyDown(nc::input::KeyCode key) const -> bool;
+
+    private:
+        struct KeyState
+        {
+            uint16_t held = 0;
+            uint16_t down = 0;
+            uint16_t up = 0;
+
+            bool operator==(const KeyState&) const = default;
+        };
+
+        struct Run
+        {
+            KeyState keys;
+            uint32_t tickCount;
+        };
+
+        inline static GameInput* m_instance = nullptr;
+
+        InputMode m_mode;
+        std::optional<uint32_t> m_seed;
+        KeyState m_latched; // live keys since the last tick
+        KeyState m_current; // this tick's keys
+        KeyState m_sinceFrame; // this tick's held keys, with presses and releases from every tick since the last frame
+        KeyState m_frame;
+        std::ofstream m_recording;
+        Run m_pending{};
+        std::vector<Run> m_replay;
+        std::unique_ptr<BotDriver> m_bot;
+        size_t m_replayRun = 0ull;
+        uint32_t m_replayTick = 0u;
+        uint64_t m_tick = 0ull;
+
+        void Record(const KeyState& keys);
+        void WriteRun(const Run& run);
+};
+
+// Gameplay's replacements for nc::input's key queries
+namespace input
+{
+// From FixedLogic
+inline auto KeyDown(nc::input::KeyCode key) -> bool { return GameInput::Instance().KeyDown(key); }
+inline auto KeyHeld(nc::input::KeyCode key) -> bool { return GameInput::Instance().KeyHeld(key); }
+inline auto KeyUp(nc::input::KeyCode key) -> bool { return GameInput::Instance().KeyUp(key); }
+
+// From FrameLogic and UI
+inline auto FrameKeyDown(nc::input::KeyCode key) -> bool { return GameInput::Instance().FrameKeyDown(key); }
+} // namespace input
+} // namespace game
@@ -1,5 +1,7 @@
 #include "MainScene.h"
+#include "AssetResidency.h"
 #include "Assets.h"
+#include "GameInput.h"
 #include "GameplayOrchestrator.h"
 #include "Tree.h"
 #include "UI.h"
@@ -8,6 +10,32 @@
 #include "ncengine/utility/Log.h"
 
 #include <iostream>
+#include <span>
+#include <string_view>
+
+struct InputOptions
+{
+    game::InputMode mode = game::InputMode::Live;
+    std::filesystem::path path;
+};
+
+// Usage: game [--record <file> | --replay <file> | --bot <metrics file>]
+auto ParseInputOptions(std::span<char*> args) -> InputOptions
+{
+    auto options = InputOptions{};
+    for (auto i = 1ull; i + 1 < args.size(); ++i)
+    {
+        const auto arg = std::string_view{args[i]};
+        if (arg == "--record")
+            options = InputOptions{game::InputMode::Record, args[++i]};
+        else if (arg == "--replay")
+            options = InputOptions{game::InputMode::Replay, args[++i]};
+        else if (arg == "--bot")
+            options = InputOptions{game::InputMode::Bot, args[++i]};
+    }
+
+    return options;
+}
 
 auto BuildConfig() -> nc::config::Config
 {
@@ -53,7 +81,7 @@ auto BuildConfig() -> nc::config::Config
     return config;
 }
 
-int GameMain()
+int GameMain(const InputOptions& inputOptions)
 {
     std::unique_ptr<nc::NcEngine> engine;
 
@@ -61,7 +89,9 @@ int GameMain()
     {
         const auto config = BuildConfig();
         engine = nc::InitializeNcEngine(config);
+        auto input = game::GameInput{inputOptions.mode, inputOptions.path};
         game::LoadAssets(config.assetSettings);
+        auto residency = game::AssetResidency{config.assetSettings, game::OnDemandAssetBudget};
         auto& world = engine->GetRegistry()->GetImpl();
         game::RegisterTreeComponents(world);
         auto ui = game::GameUI{engine.get()};
@@ -85,16 +115,22 @@ int GameMain()
 #ifdef GAME_PROD_BUILD
 #include "ncengine/platform/win32/NcWin32.h"
 
+#include <cstdlib>
+
 int WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 {
-    return GameMain();
+    // The CRT still splits the command line for GUI apps
+    if (!__argv)
+        return GameMain(InputOptions{});
+
+    return GameMain(ParseInputOptions(std::span{__argv, static_cast<size_t>(__argc)}));
 }
 
 #else
 
-int main()
+int main(int argc, char** argv)
 {
-    return GameMain();
+    return GameMain(ParseInputOptions(std::span{argv, static_cast<size_t>(argc)}));
 }
 
 #endif
@@ -1,13 +1,18 @@
 #include "GameplayOrchestrator.h"
+#include "AssetResidency.h"
 #include "Assets.h"
 #include "Character.h"
 #include "Core.h"
 #include "Dialog.h"
 #include "FollowCamera.h"
+#include "GameInput.h"
+#include "LightAnimator.h"
 #include "MainScene.h"
+#include "ParticleBudget.h"
 #include "Sasquatch.h"
 #include "Tree.h"
 #include "UI.h"
+#include "VoiceManager.h"
 
 #include "ncengine/graphics/SkeletalAnimator.h"
 
@@ -58,109 +63,47 @@ void DisableGameplayMechanics(nc::ecs::Ecs world, float followDistance = 5.0f, f
 
 void StopMusic(nc::ecs::Ecs world)
 {
-    auto introTheme = game::GetComponentByEntityTag<nc::audio::AudioSource>(world, game::tag::IntroThemeMusic);
-    if (introTheme->IsPlaying()) introTheme->Stop();
+    // The source is dropped once the theme finishes, see ReleaseMusic
+    const auto introTheme = world.GetEntityByTag(game::tag::IntroThemeMusic);
+    if (world.Contains<nc::audio::AudioSource>(introTheme))
+        game::GetComponentByEntityTag<game::VoiceManager>(world, game::tag::VoiceManager)->Stop(introTheme);
 }
 
-auto GetPointLightValues(std::span<nc::graphics::PointLight> lights) -> std::vector<std::pair<nc::Vector3, nc::Vector3>>
-{
-    auto out = std::vector<std::pair<nc::Vector3, nc::Vector3>>{};
-    out.reserve(lights.size());
-    for (auto& light : lights)
-    {
-        out.emplace_back(light.GetAmbient(), light.GetDiffuseColor());
-    }
-
-    return out;
-}
+const auto MusicTracks = std::array{
+    std::pair{std::string_view{game::tag::IntroThemeMusic}, std::string_view{game::IntroThemeMusic}},
+    std::pair{std::string_view{game::tag::BlightClearedMusic}, std::string_view{game::BlightClearedMusic}},
+    std::pair{std::string_view{game::tag::LoseMusic}, std::string_view{game::LoseMusic}},
+    std::pair{std::string_view{game::tag::EndingMusic}, std::string_view{game::EndingMusic}}
+};
 
-void SetPointLightsToBlack(std::span<nc::graphics::PointLight> lights)
+// Music sources are created on first play, since their clips aren't loaded until then. Each source holds its clip.
+void PlayMusic(nc::ecs::Ecs world, std::string_view tag, std::string_view clip)
 {
-    for (auto& light : lights)
+    const auto entity = world.GetEntityByTag(tag);
+    if (!world.Contains<nc::audio::AudioSource>(entity))
     {
-        light.SetAmbient(nc::Vector3{});
-        light.SetDiffuseColor(nc::Vector3{});
+        game::AssetResidency::Instance().Acquire(game::AssetType::AudioClip, clip);
+        world.Emplace<nc::audio::AudioSource>(entity, clip, nc::audio::AudioSourceProperties{.gain = 0.4f, .loop = false});
     }
-}
-
-void StepFadeIn(std::span<nc::graphics::PointLight> lights, const std::vector<std::pair<nc::Vector3, nc::Vector3>>& initialValues, float dt)
-{
-    constexpr auto fade = [](const nc::Vector3& from, const nc::Vector3& to, float factor)
-    {
-        auto out = nc::Vector3{};
-        out.x = std::clamp(std::lerp(from.x, to.x, factor), 0.0f, to.x);
-        out.y = std::clamp(std::lerp(from.y, to.y, factor), 0.0f, to.y);
-        out.z = std::clamp(std::lerp(from.z, to.z, factor), 0.0f, to.z);
-        return out;
-    };
 
-    constexpr auto fadeFactor = 0.15f;
-    const auto factor = std::clamp(fadeFactor * dt, 0.0f, 1.0f);
-
-    for (auto [light, value] : std::views::zip(lights, initialValues))
-    {
-        light.SetAmbient(fade(light.GetAmbient(), value.first, factor));
-        light.SetDiffuseColor(fade(light.GetDiffuseColor(), value.second, factor));
-    }
+    game::GetComponentByEntityTag<game::VoiceManager>(world, game::tag::VoiceManager)->Play(entity);
 }
 
-void StepFadeToBlack(nc::ecs::Ecs world, float dt)
+// Tracks don't repeat, so drop each source once it finishes - or right away, when the scene is going away. Their clips
+// are returned in 'releases', to be released once the removal has been committed.
+void ReleaseMusic(nc::ecs::Ecs world, bool finishedOnly, std::vector<std::string_view>& releases)
 {
-    constexpr auto fade = [](const nc::Vector3& in, float factor)
-    {
-        auto out = nc::Vector3{};
-        out.x = nc::Lerp(in.x, 0.0f, factor);
-        out.y = nc::Lerp(in.y, 0.0f, factor);
-        out.z = nc::Lerp(in.z, 0.0f, factor);
-        return out;
-    };
-
-    constexpr auto fadeFactor = 1.3f;
-    const auto factor = fadeFactor * dt;
-
-    for (auto& light : world.GetAll<nc::graphics::PointLight>())
+    auto voices = game::GetComponentByEntityTag<game::VoiceManager>(world, game::tag::VoiceManager);
+    for (const auto& [tag, clip] : MusicTracks)
     {
-        light.SetAmbient(fade(light.GetAmbient(), factor));
-        light.SetDiffuseColor(fade(light.GetDiffuseColor(), factor));
-    }
-}
-
-class LightFader : public nc::FreeComponent
-{
-    public:
-        LightFader(nc::Entity self, nc::ecs::Ecs world)
-            : nc::FreeComponent{self}, m_world{world} {}
-
-        void Run(nc::Entity self, nc::Registry*, float dt)
+        const auto entity = world.GetEntityByTag(tag);
+        if (world.Contains<nc::audio::AudioSource>(entity) && (!finishedOnly || !voices->IsPlaying(entity)))
         {
-            auto lights = m_world.GetAll<nc::graphics::PointLight>();
-            static auto lightValues = ::GetPointLightValues(lights);
-
-            if (m_runTime == 0.0f)
-                ::SetPointLightsToBlack(lights);
-
-            m_runTime += dt;
-
-            if (m_runTime < 2.0f)
-                return;
-
-            if (m_runTime < 10.0f)
-                ::StepFadeIn(lights, lightValues, dt + m_runTime * 0.015f);
-            else
-            {
-                for (auto [light, value] : std::views::zip(lights, lightValues))
-                {
-                    light.SetAmbient(value.first);
-                    light.SetDiffuseColor(value.second);
-                }
-                m_world.Remove<nc::Entity>(self);
-            }
+            world.Remove<nc::audio::AudioSource>(entity);
+            releases.push_back(clip);
         }
-
-    private:
-        nc::ecs::Ecs m_world;
-        float m_runTime = 0.0f;
-};
+    }
+}
 } // anonymous namespace
 
 namespace game
@@ -230,7 +173,7 @@ void Cutscene::Update(nc::ecs::Ecs world, GameUI* ui)
         m_initialDialogPlayed = true;
         ui->AddNewDialog(m_dialogSequence[m_currentDialog++].data());
     }
-    else if (KeyDown(nc::input::KeyCode::Space))
+    else if (input::FrameKeyDown(hotkey::AdvanceDialog))
     {
         if (m_currentDialog < m_dialogSequence.size())
             ui->AddNewDialog(m_dialogSequence[m_currentDialog].data());
@@ -290,6 +233,9 @@ void GameplayOrchestrator::Run(float dt)
 {
     constexpr auto flavorTextDelay = 10.0f;
 
+    ReleaseClips();
+    ::ReleaseMusic(m_world, true, m_queuedClipReleases);
+
     // need to do before cutscene because it can start them
     if (m_spreadStarted)
     {
@@ -304,7 +250,7 @@ void GameplayOrchestrator::Run(float dt)
     }
 
 #ifndef GAME_PROD_BUILD
-    if (KeyDown(hotkey::SkipToSpreadEvent))
+    if (input::FrameKeyDown(hotkey::SkipToSpreadEvent))
     {
         FireEvent(Event::StartSpread);
         return;
@@ -353,6 +299,7 @@ void GameplayOrchestrator::Run(float dt)
         }
         case Event::CampEncounter:
         {
+            AssetResidency::Instance().Prefetch(AssetType::SkeletalAnimation, DaveStandupStump); // for the elder
             // enable elder encounter after camp
             SetAnimatorState(m_world, DaveSittingStump, tag::Elder);
             AttachElderQuestTrigger(m_world);
@@ -378,7 +325,8 @@ void GameplayOrchestrator::Run(float dt)
             {
                 ::DisableGameplayMechanics(m_world, 5.0f, 20.0f, 0.25f);
                 ::StopMusic(m_world);
-                GetComponentByEntityTag<nc::audio::AudioSource>(m_world, tag::EndingMusic)->Play();
+                ::PlayMusic(m_world, tag::EndingMusic, EndingMusic);
+                GetComponentByEntityTag<LightAnimator>(m_world, tag::LightAnimator)->AnimateAll(m_world, LightTarget::Black, curve::FadeToBlack);
             }
 
             m_timeInCurrentEvent += dt;
@@ -390,7 +338,6 @@ void GameplayOrchestrator::Run(float dt)
                 return;
             }
 
-            ::StepFadeToBlack(m_world, dt);
             break;
         }
         case Event::Lose:
@@ -404,7 +351,6 @@ void GameplayOrchestrator::Run(float dt)
                 return;
             }
 
-            ::StepFadeToBlack(m_world, dt);
             break;
         }
         default: break;
@@ -423,31 +369,66 @@ void GameplayOrchestrator::Clear()
     m_currentCutscene = Cutscene{};
 }
 
+void GameplayOrchestrator::QueueSceneReload()
+{
+    m_engine->QueueSceneChange(std::make_unique<MainScene>([this](float dt) { Run(dt); }));
+}
+
 void GameplayOrchestrator::SetEvent(Event event)
 {
     m_currentEvent = event;
 }
 
+void GameplayOrchestrator::RemoveTitleScreen()
+{
+    if (m_titleScreen.Valid())
+    {
+        m_world.Remove<nc::Entity>(m_titleScreen);
+        m_titleScreen = nc::Entity::Null();
+    }
+}
+
+// Separate from removing the emitter, as the removal isn't committed until the end of the frame
+void GameplayOrchestrator::ReleaseTitleScreen()
+{
+    if (m_holdingTitleScreen)
+    {
+        AssetResidency::Instance().Release(TitleScreenParticle);
+        m_holdingTitleScreen = false;
+    }
+}
+
+// A clip queued before this Run may have been queued earlier in the same frame, with its source's removal still staged,
+// so everything waits for the next Run. By then the sources have been removed, or the scene holding them replaced, and
+// the audio thread can no longer be reading the clips.
+void GameplayOrchestrator::ReleaseClips()
+{
+    for (auto clip : m_committedClipReleases)
+    {
+        AssetResidency::Instance().Release(clip);
+    }
+
+    m_committedClipReleases = std::exchange(m_queuedClipReleases, {});
+}
+
 void GameplayOrchestrator::HandleTitleScreen()
 {
     SetEvent(Event::TitleScreen);
     ::SetCameraTargetToFocusPoint(m_world, tag::IntroFocusPoint);
+    AssetResidency::Instance().Acquire(AssetType::Texture, TitleScreenParticle);
+    m_holdingTitleScreen = true;
 
-    auto fader = m_world.Emplace<nc::Entity>({
-        .tag = "PointLightFader",
-        .flags = nc::Entity::Flags::NoSerialize
-    });
-
-    m_world.Emplace<LightFader>(fader, m_world);
-    m_world.Emplace<nc::FrameLogic>(fader, nc::InvokeFreeComponent<LightFader>{});
+    auto lights = GetComponentByEntityTag<LightAnimator>(m_world, tag::LightAnimator);
+    lights->SetAll(m_world, LightTarget::Black);
+    lights->AnimateAll(m_world, LightTarget::Base, curve::FadeInFromBlack);
 
     auto camTrans = GetComponentByEntityTag<nc::Transform>(m_world, tag::MainCamera);
-    auto title = m_world.Emplace<nc::Entity>({
+    m_titleScreen = m_world.Emplace<nc::Entity>({
         .position = camTrans->Position() + camTrans->Forward() * 5.0f,
         .flags = nc::Entity::Flags::NoSerialize
     });
 
-    m_world.Emplace<nc::graphics::ParticleEmitter>(title, nc::graphics::ParticleInfo{
+    m_world.Emplace<nc::graphics::ParticleEmitter>(m_titleScreen, nc::graphics::ParticleInfo{
         .emission = {
             .initialEmissionCount = 1,
         },
@@ -470,12 +451,14 @@ void GameplayOrchestrator::HandleIntro()
 {
     SetEvent(Event::Intro);
     m_currentCutscene.Enter(m_world, tag::IntroFocusPoint, dialog::Intro);
+    RemoveTitleScreen();
 }
 
 void GameplayOrchestrator::HandleBegin()
 {
     SetEvent(Event::None);
     m_ui->AddNewDialog(dialog::Controls);
+    ReleaseTitleScreen(); // the emitter went away with the start of the intro cutscene, so nothing is drawing it
 }
 
 void GameplayOrchestrator::HandleDaveEncounter()
@@ -519,6 +502,10 @@ void GameplayOrchestrator::HandleStartSpread()
     FinalizeTrees(m_world);
     m_ui->AddNewDialog(dialog::StartSpread);
     m_ui->ToggleTreeCounter(true);
+
+    // The spread ends in one of these, and loading mid-game is much less noticeable than at the moment it ends
+    AssetResidency::Instance().Prefetch(AssetType::AudioClip, BlightClearedMusic);
+    AssetResidency::Instance().Prefetch(AssetType::AudioClip, LoseMusic);
     // StopMusic
 }
 
@@ -530,7 +517,8 @@ void GameplayOrchestrator::HandleTreesCleared()
     m_ui->ToggleTreeCounter(false);
     m_ui->AddNewDialog(dialog::TreesCleared);
     ::StopMusic(m_world);
-    GetComponentByEntityTag<nc::audio::AudioSource>(m_world, tag::BlightClearedMusic)->Play();
+    ::PlayMusic(m_world, tag::BlightClearedMusic, BlightClearedMusic);
+    AssetResidency::Instance().Prefetch(AssetType::AudioClip, EndingMusic);
 }
 
 void GameplayOrchestrator::HandleFlavorDialog()
@@ -541,7 +529,14 @@ void GameplayOrchestrator::HandleNewGame()
 {
     SetEvent(Event::NewGame);
     Clear();
-    m_engine->QueueSceneChange(std::make_unique<MainScene>([this](float dt) { Run(dt); }));
+
+    // The scene holding these is about to be destroyed
+    RemoveTitleScreen();
+    ReleaseTitleScreen();
+    ::ReleaseMusic(m_world, false, m_queuedClipReleases);
+    m_queuedClipReleases.push_back(ForestAmbienceSfx);
+    ReleaseAnimations(m_world);
+    QueueSceneReload();
 }
 
 void GameplayOrchestrator::HandleWin()
@@ -562,7 +557,8 @@ void GameplayOrchestrator::HandleLose()
     ::DisableGameplayMechanics(world);
     m_spreadStarted = false;
     ::StopMusic(m_world);
-    GetComponentByEntityTag<nc::audio::AudioSource>(m_world, tag::LoseMusic)->Play();
+    ::PlayMusic(m_world, tag::LoseMusic, LoseMusic);
+    GetComponentByEntityTag<LightAnimator>(m_world, tag::LightAnimator)->AnimateAll(m_world, LightTarget::Black, curve::FadeToBlack);
 }
 
 void GameplayOrchestrator::ProcessTrees(float dt)
@@ -578,9 +574,10 @@ void GameplayOrchestrator::ProcessTrees(float dt)
             return;
         }
 
+        auto particleBudget = GetComponentByEntityTag<ParticleBudget>(m_world, tag::ParticleBudget);
         for (auto& infected : infectedTrees)
         {
-            infected.Update(m_world, dt);
+            infected.Update(m_world, *particleBudget, dt);
         }
 
         auto healthyTrees = m_world.GetAll<HealthyTree>();
@@ -39,6 +39,12 @@ class GameplayOrchestrator : public nc::StableAddress
         void Run(float dt);
         void Clear();
 
+        // Replace the scene with a freshly loaded one once the current frame has finished
+        void QueueSceneReload();
+
+        auto GetCurrentEvent() const noexcept { return m_currentEvent; }
+        auto IsInCutscene() -> bool { return m_currentCutscene.IsRunning(); }
+
     private:
         inline static GameplayOrchestrator* m_instance = nullptr;
         nc::NcEngine* m_engine;
@@ -52,8 +58,15 @@ class GameplayOrchestrator : public nc::StableAddress
         bool m_spreadStarted = false;
         size_t m_healthyCount = 0ull;
         size_t m_infectedCount = 0ull;
+        nc::Entity m_titleScreen = nc::Entity::Null();
+        bool m_holdingTitleScreen = false;
+        std::vector<std::string_view> m_queuedClipReleases;
+        std::vector<std::string_view> m_committedClipReleases;
 
         void SetEvent(Event event);
+        void RemoveTitleScreen();
+        void ReleaseTitleScreen();
+        void ReleaseClips();
 
         void HandleTitleScreen();
         void HandleIntro();
@@ -0,0 +1,125 @@
+#include "InfectedTreeIndex.h"
+
+namespace
+{
+auto CellCoordinate(float value) -> size_t
+{
+    constexpr auto maxCell = static_cast<float>(game::InfectedTreeIndex::CellsPerSide - 1);
+    const auto cell = std::floor((value + game::map::HalfExtent) / game::InfectedTreeIndex::CellSize);
+    return static_cast<size_t>(std::clamp(cell, 0.0f, maxCell));
+}
+
+auto CellIndex(float x, float z) -> size_t
+{
+    return ::CellCoordinate(z) * game::InfectedTreeIndex::CellsPerSide + ::CellCoordinate(x);
+}
+} // anonymous namespace
+
+namespace game
+{
+InfectedTreeIndex::InfectedTreeIndex(nc::Entity self)
+    : nc::FreeComponent{self},
+      m_cells(CellsPerSide * CellsPerSide)
+{
+}
+
+void InfectedTreeIndex::Insert(nc::Entity tree, const nc::Vector3& position, float radius)
+{
+    m_cells[::CellIndex(position.x, position.z)].emplace_back(tree, position.x, position.z, radius);
+    m_maxRadius = std::max(m_maxRadius, radius);
+}
+
+void InfectedTreeIndex::Remove(nc::Entity tree, const nc::Vector3& position)
+{
+    auto& cell = m_cells[::CellIndex(position.x, position.z)];
+    const auto pos = std::ranges::find(cell, tree, &Entry::tree);
+    NC_ASSERT(pos != cell.end(), "Tree is not in the index");
+    *pos = cell.back();
+    cell.pop_back();
+}
+
+void InfectedTreeIndex::SweepSphere(const nc::Vector3& from, const nc::Vector3& to, float radius, std::vector<SweepHit>& hits) const
+{
+    hits.clear();
+
+    // Trees are binned by center, so widen the search by the largest tree as well
+    const auto reach = radius + m_maxRadius;
+    const auto minX = ::CellCoordinate(std::min(from.x, to.x) - reach);
+    const auto maxX = ::CellCoordinate(std::max(from.x, to.x) + reach);
+    const auto minZ = ::CellCoordinate(std::min(from.z, to.z) - reach);
+    const auto maxZ = ::CellCoordinate(std::max(from.z, to.z) + reach);
+
+    const auto pathX = to.x - from.x;
+    const auto pathZ = to.z - from.z;
+    const auto lengthSquared = pathX * pathX + pathZ * pathZ;
+    const auto length = std::sqrt(lengthSquared);
+
+    for (auto z = minZ; z <= maxZ; ++z)
+    {
+        for (auto x = minX; x <= maxX; ++x)
+        {
+            for (const auto& entry : m_cells[z * CellsPerSide + x])
+            {
+                // Closest point on the path to the tree, then back up to where the sphere first touches it
+                const auto toTreeX = entry.x - from.x;
+                const auto toTreeZ = entry.z - from.z;
+                const auto closest = lengthSquared > 0.0f ? std::clamp((toTreeX * pathX + toTreeZ * pathZ) / lengthSquared, 0.0f, 1.0f) : 0.0f;
+                const auto offsetX = toTreeX - pathX * closest;
+                const auto offsetZ = toTreeZ - pathZ * closest;
+                const auto distanceSquared = offsetX * offsetX + offsetZ * offsetZ;
+                const auto touch = radius + entry.radius;
+                if (distanceSquared > touch * touch)
+                    continue;
+
+                const auto backup = length > 0.0f ? std::sqrt(touch * touch - distanceSquared) / length : 0.0f;
+                hits.emplace_back(entry.tree, std::max(closest - backup, 0.0f));
+            }
+        }
+    }
+
+    std::ranges::stable_sort(hits, {}, &SweepHit::fraction);
+}
+
+auto InfectedTreeIndex::FindNearest(const nc::Vector3& position) const -> std::optional<nc::Vector3>
+{
+    const auto centerX = static_cast<std::ptrdiff_t>(::CellCoordinate(position.x));
+    const auto centerZ = static_cast<std::ptrdiff_t>(::CellCoordinate(position.z));
+    const auto cellsPerSide = static_cast<std::ptrdiff_t>(CellsPerSide);
+
+    const Entry* nearest = nullptr;
+    auto nearestDistanceSquared = std::numeric_limits<float>::max();
+    for (auto ring = std::ptrdiff_t{0}; ring < cellsPerSide; ++ring)
+    {
+        // Anything in this ring or beyond is at least this far away, so stop once something closer has been found
+        const auto ringDistance = static_cast<float>(ring - 1) * CellSize;
+        if (nearest && ring > 0 && nearestDistanceSquared <= ringDistance * ringDistance)
+            break;
+
+        for (auto z = centerZ - ring; z <= centerZ + ring; ++z)
+        {
+            for (auto x = centerX - ring; x <= centerX + ring; ++x)
+            {
+                const auto onRing = std::max(std::abs(x - centerX), std::abs(z - centerZ)) == ring;
+                if (!onRing || x < 0 || z < 0 || x >= cellsPerSide || z >= cellsPerSide)
+                    continue;
+
+                for (const auto& entry : m_cells[static_cast<size_t>(z * cellsPerSide + x)])
+                {
+                    const auto offsetX = entry.x - position.x;
+                    const auto offsetZ = entry.z - position.z;
+                    if (const auto distanceSquared = offsetX * offsetX + offsetZ * offsetZ; distanceSquared < nearestDistanceSquared)
+                    {
+                        nearest = &entry;
+                        nearestDistanceSquared = distanceSquared;
+                    }
+                }
+            }
+        }
+    }
+
+    if (!nearest)
+        return std::nullopt;
+
+    return nc::Vector3{nearest->x, position.y, nearest->z};
+}
+} // namespace game
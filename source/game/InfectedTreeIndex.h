@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Core.h"
+
+#include <optional>
+
+namespace game
+{
+struct SweepHit
+{
+    nc::Entity tree;
+    float fraction; // how far along the sweep the sphere first touches the tree
+};
+
+// Uniform grid of infected trees on the ground plane, for resolving purification without physics. Trees are treated
+// as circles bounding their collider's footprint, which is all a sweep along the ground needs.
+class InfectedTreeIndex : public nc::FreeComponent
+{
+    public:
+        static constexpr auto CellSize = 15.0f;
+        static constexpr auto CellsPerSide = static_cast<size_t>(map::Extent / CellSize);
+
+        explicit InfectedTreeIndex(nc::Entity self);
+
+        void Insert(nc::Entity tree, const nc::Vector3& position, float radius);
+        void Remove(nc::Entity tree, const nc::Vector3& position);
+
+        // Replaces 'hits' with the trees touched by a sphere moving from 'from' to 'to', ordered along the path
+        void SweepSphere(const nc::Vector3& from, const nc::Vector3& to, float radius, std::vector<SweepHit>& hits) const;
+
+        // Ground position of the tree closest to 'position', searching outward a ring of cells at a time
+        auto FindNearest(const nc::Vector3& position) const -> std::optional<nc::Vector3>;
+
+    private:
+        struct Entry
+        {
+            nc::Entity tree;
+            float x;
+            float z;
+            float radius;
+        };
+
+        std::vector<std::vector<Entry>> m_cells;
+        float m_maxRadius = 0.0f;
+};
+} // namespace game
@@ -0,0 +1,113 @@
+#include "LightAnimator.h"
+
+namespace game
+{
+LightAnimator::LightAnimator(nc::Entity self)
+    : nc::FreeComponent{self}
+{
+}
+
+void LightAnimator::AnimateAll(nc::ecs::Ecs world, LightTarget target, const LightCurve& curve)
+{
+    Capture(world);
+    for (auto i = 0ull; i < m_lightCount; ++i)
+    {
+        Start(i, target, curve);
+    }
+}
+
+void LightAnimator::Animate(nc::ecs::Ecs world, nc::Entity light, LightTarget target, const LightCurve& curve)
+{
+    Capture(world);
+    const auto index = m_lights->Find(light);
+    NC_ASSERT(index < m_lightCount, "Light was added after the animator captured lights");
+    Start(index, target, curve);
+}
+
+void LightAnimator::SetAll(nc::ecs::Ecs world, LightTarget target)
+{
+    Capture(world);
+    if (target == LightTarget::Base)
+        m_current = m_base;
+    else
+        std::ranges::fill(m_current, 0.0f);
+
+    std::ranges::fill(m_curves, nullptr);
+    for (auto i = 0ull; i < m_lightCount; ++i)
+    {
+        Apply(i);
+    }
+}
+
+void LightAnimator::Run(nc::Entity, nc::Registry*, float dt)
+{
+    if (std::ranges::none_of(m_curves, [](const LightCurve* curve) { return curve != nullptr; }))
+        return;
+
+    const auto lightCount = m_lightCount;
+    for (auto i = 0ull; i < lightCount; ++i)
+    {
+        const auto curve = m_curves[i];
+        m_elapsed[i] += dt;
+        m_weights[i] = curve ? curve->Evaluate(m_elapsed[i]) : 0.0f;
+    }
+
+    // Idle lights are blended too, rather than branching per light, and just aren't written back
+    for (auto i = 0ull; i < lightCount * Channels; ++i)
+    {
+        const auto weight = m_weights[i / Channels];
+        m_current[i] = m_from[i] + (m_to[i] - m_from[i]) * weight;
+    }
+
+    for (auto i = 0ull; i < lightCount; ++i)
+    {
+        if (!m_curves[i])
+            continue;
+
+        Apply(i);
+        if (m_elapsed[i] >= m_curves[i]->Duration())
+            m_curves[i] = nullptr;
+    }
+}
+
+void LightAnimator::Capture(nc::ecs::Ecs world)
+{
+    if (m_captured)
+        return;
+
+    m_captured = true;
+    m_lights = GetComponentByEntityTag<LightClusterer>(world, tag::LightClusterer);
+    m_lights->Adopt(world);
+    m_lightCount = m_lights->GetLightCount();
+    for (auto i = 0ull; i < m_lightCount; ++i)
+    {
+        std::ranges::copy(m_lights->GetColor(i), std::back_inserter(m_base));
+    }
+
+    m_from = m_base;
+    m_to = m_base;
+    m_current = m_base;
+    m_curves.assign(m_lightCount, nullptr);
+    m_elapsed.assign(m_lightCount, 0.0f);
+    m_weights.assign(m_lightCount, 0.0f);
+}
+
+void LightAnimator::Start(size_t index, LightTarget target, const LightCurve& curve)
+{
+    const auto first = static_cast<std::ptrdiff_t>(index * Channels);
+    const auto current = m_current.begin() + first;
+    std::copy(current, current + Channels, m_from.begin() + first);
+    if (target == LightTarget::Base)
+        std::copy_n(m_base.begin() + first, Channels, m_to.begin() + first);
+    else
+        std::fill_n(m_to.begin() + first, Channels, 0.0f);
+
+    m_curves[index] = &curve;
+    m_elapsed[index] = 0.0f;
+}
+
+void LightAnimator::Apply(size_t index)
+{
+    m_lights->SetColor(index, std::span<const float, Channels>{m_current.data() + index * Channels, Channels});
+}
+} // namespace game
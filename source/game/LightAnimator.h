@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Core.h"
+#include "LightClusterer.h"
+
+namespace game
+{
+struct LightKey
+{
+    float time;
+    float weight; // 0 is where the animation started from, 1 is its target
+};
+
+// Piecewise linear weight over time. Keys must be in time order.
+struct LightCurve
+{
+    static constexpr auto MaxKeys = 6ull;
+
+    std::array<LightKey, MaxKeys> keys;
+    size_t keyCount;
+
+    constexpr auto Duration() const -> float { return keys[keyCount - 1].time; }
+    constexpr auto Evaluate(float time) const -> float
+    {
+        if (time <= keys[0].time)
+            return keys[0].weight;
+
+        for (auto i = 1ull; i < keyCount; ++i)
+        {
+            if (time < keys[i].time)
+            {
+                const auto& from = keys[i - 1];
+                const auto& to = keys[i];
+                return from.weight + (to.weight - from.weight) * (time - from.time) / (to.time - from.time);
+            }
+        }
+
+        return keys[keyCount - 1].weight;
+    }
+};
+
+namespace curve
+{
+// Hold in darkness, then ease up to full - for the title screen
+constexpr auto FadeInFromBlack = LightCurve{{{{0.0f, 0.0f}, {2.0f, 0.0f}, {4.0f, 0.45f}, {6.0f, 0.8f}, {10.0f, 1.0f}}}, 5ull};
+
+// Quick drop that tails off - for the end of the game
+constexpr auto FadeToBlack = LightCurve{{{{0.0f, 0.0f}, {0.5f, 0.48f}, {1.5f, 0.86f}, {3.0f, 0.98f}, {5.0f, 1.0f}}}, 5ull};
+} // namespace curve
+
+enum class LightTarget : uint8_t
+{
+    Base, // the colors a light had when first seen
+    Black
+};
+
+// Animates light colors along curves. Lights are taken from the LightClusterer once, on first use, and their colors are
+// kept in packed arrays, so each frame is one pass over every light with no registry queries or allocation. Results
+// are written back to the clusterer, which decides which lights are actually shown. Each light runs at most
+// one animation - starting another blends from wherever the light currently is. Curves are held by pointer, so pass
+// ones that outlive the animation, like those in game::curve.
+class LightAnimator : public nc::FreeComponent
+{
+    public:
+        explicit LightAnimator(nc::Entity self);
+
+        void AnimateAll(nc::ecs::Ecs world, LightTarget target, const LightCurve& curve);
+        void Animate(nc::ecs::Ecs world, nc::Entity light, LightTarget target, const LightCurve& curve);
+
+        // Jump every light to a target, cancelling any animations
+        void SetAll(nc::ecs::Ecs world, LightTarget target);
+
+        void Run(nc::Entity self, nc::Registry* registry, float dt);
+
+    private:
+        static constexpr auto Channels = LightChannels;
+
+        LightClusterer* m_lights = nullptr;
+        size_t m_lightCount = 0ull;
+        std::vector<float> m_base;
+        std::vector<float> m_from;
+        std::vector<float> m_to;
+        std::vector<float> m_current;
+        std::vector<const LightCurve*> m_curves; // null when idle
+        std::vector<float> m_elapsed;
+        std::vector<float> m_weights;
+        bool m_captured = false;
+
+        void Capture(nc::ecs::Ecs world);
+        void Start(size_t index, LightTarget target, const LightCurve& curve);
+        void Apply(size_t index);
+};
+} // namespace game
@@ -0,0 +1,231 @@
+#include "LightClusterer.h"
+
+namespace
+{
+auto Luminance(std::span<const float, game::LightChannels> color) -> float
+{
+    return 0.2126f * (color[0] + color[3]) + 0.7152f * (color[1] + color[4]) + 0.0722f * (color[2] + color[5]);
+}
+
+// Ground-plane direction, so tilting the camera doesn't stretch the grid
+auto Flatten(const nc::Vector3& direction) -> nc::Vector3
+{
+    const auto flat = nc::Vector3{direction.x, 0.0f, direction.z};
+    const auto length = nc::Magnitude(flat);
+    return length > 0.0001f ? flat / length : nc::Vector3::Front();
+}
+
+auto CellIndex(float value, float min, float max, size_t count) -> size_t
+{
+    const auto cell = static_cast<size_t>(std::max((value - min) / (max - min) * static_cast<float>(count), 0.0f));
+    return std::min(cell, count - 1);
+}
+} // anonymous namespace
+
+namespace game
+{
+LightClusterer::LightClusterer(nc::Entity self)
+    : nc::FreeComponent{self}
+{
+    m_slots.fill(nc::Entity::Null());
+    m_slotLights.fill(NoLight);
+}
+
+auto LightClusterer::AddLight(const nc::Vector3& position, const nc::Vector3& ambient, const nc::Vector3& diffuse, float radius, nc::Entity source) -> size_t
+{
+    m_lights.emplace_back(position, radius, source);
+    m_colors.insert(m_colors.end(), {ambient.x, ambient.y, ambient.z, diffuse.x, diffuse.y, diffuse.z});
+    return m_lights.size() - 1;
+}
+
+void LightClusterer::Adopt(nc::ecs::Ecs world)
+{
+    if (m_adopted)
+        return;
+
+    m_adopted = true;
+    auto adopted = std::vector<nc::Entity>{};
+    for (const auto& light : world.GetAll<nc::graphics::PointLight>())
+    {
+        const auto entity = light.ParentEntity();
+        AddLight(world.Get<nc::Transform>(entity)->Position(), light.GetAmbient(), light.GetDiffuseColor(), light.GetRadius(), entity);
+        adopted.push_back(entity);
+    }
+
+    for (auto entity : adopted)
+    {
+        world.Remove<nc::graphics::PointLight>(entity);
+    }
+
+    if (!adopted.empty())
+        NC_LOG_INFO(fmt::format("Clustering {} lights into {} slots", m_lights.size(), RealLightCount));
+}
+
+auto LightClusterer::Find(nc::Entity source) const -> size_t
+{
+    const auto pos = std::ranges::find(m_lights, source, &VirtualLight::source);
+    NC_ASSERT(pos != m_lights.end(), "Light not found");
+    return static_cast<size_t>(std::distance(m_lights.begin(), pos));
+}
+
+auto LightClusterer::GetColor(size_t index) const -> std::span<const float, LightChannels>
+{
+    return std::span<const float, LightChannels>{m_colors.data() + index * LightChannels, LightChannels};
+}
+
+void LightClusterer::SetColor(size_t index, std::span<const float, LightChannels> color)
+{
+    std::ranges::copy(color, m_colors.begin() + static_cast<std::ptrdiff_t>(index * LightChannels));
+}
+
+void LightClusterer::Run(nc::Entity, nc::Registry* registry, float)
+{
+    auto world = registry->GetEcs();
+    if (!m_adopted)
+    {
+        Adopt(world);
+        return;
+    }
+
+    if (!m_slotsCreated)
+    {
+        CreateSlots(world);
+        return;
+    }
+
+    if (!m_camera.Valid())
+        return;
+
+    const auto camera = world.Get<nc::Transform>(m_camera);
+    Bin(camera->Position(), ::Flatten(camera->Right()), ::Flatten(camera->Forward()));
+
+    // Every cell's best light before any cell's second best, so the whole view gets some light
+    auto candidateCount = 0ull;
+    for (auto cell = 0ull; cell < ClusterCount; ++cell)
+    {
+        for (auto i = 0ull; i < m_clusterSizes[cell]; ++i)
+        {
+            m_candidates[candidateCount++] = m_clusters[cell][i];
+        }
+    }
+
+    const auto candidates = std::span{m_candidates.data(), candidateCount};
+    const auto selectedCount = std::min(candidateCount, RealLightCount);
+    std::ranges::partial_sort(candidates, candidates.begin() + static_cast<std::ptrdiff_t>(selectedCount), [](const Candidate& lhs, const Candidate& rhs)
+    {
+        return lhs.rank != rhs.rank ? lhs.rank < rhs.rank : lhs.influence > rhs.influence;
+    });
+
+    AssignSlots(candidates.first(selectedCount));
+    m_shownCount = selectedCount;
+
+    for (auto slot = 0ull; slot < RealLightCount; ++slot)
+    {
+        auto pointLight = world.Get<nc::graphics::PointLight>(m_slots[slot]);
+        const auto index = m_slotLights[slot];
+        if (index == NoLight)
+        {
+            pointLight->SetAmbient(nc::Vector3::Zero());
+            pointLight->SetDiffuseColor(nc::Vector3::Zero());
+            continue;
+        }
+
+        const auto& light = m_lights[index];
+        const auto color = GetColor(index);
+        world.Get<nc::Transform>(m_slots[slot])->SetPosition(light.position);
+        pointLight->SetAmbient(nc::Vector3{color[0], color[1], color[2]});
+        pointLight->SetDiffuseColor(nc::Vector3{color[3], color[4], color[5]});
+        pointLight->SetRadius(light.radius);
+    }
+}
+
+void LightClusterer::CreateSlots(nc::ecs::Ecs world)
+{
+    m_slotsCreated = true;
+    for (auto& slot : m_slots)
+    {
+        slot = world.Emplace<nc::Entity>({
+            .parent = ParentEntity(),
+            .tag = "LightSlot",
+            .flags = nc::Entity::Flags::NoSerialize
+        });
+
+        world.Emplace<nc::graphics::PointLight>(slot, nc::Vector3::Zero(), nc::Vector3::Zero());
+    }
+}
+
+void LightClusterer::Bin(const nc::Vector3& origin, const nc::Vector3& right, const nc::Vector3& forward)
+{
+    m_clusterSizes.fill(0ull);
+    for (auto index = 0ull; index < m_lights.size(); ++index)
+    {
+        const auto luminance = ::Luminance(GetColor(index));
+        if (luminance <= 0.001f)
+            continue;
+
+        const auto& light = m_lights[index];
+        const auto offset = light.position - origin;
+        const auto x = nc::Dot(offset, right);
+        const auto z = nc::Dot(offset, forward);
+        if (x + light.radius < -GridHalfWidth || x - light.radius > GridHalfWidth ||
+            z + light.radius < GridNear || z - light.radius > GridFar)
+        {
+            continue;
+        }
+
+        const auto cell = ::CellIndex(z, GridNear, GridFar, ClusterCountZ) * ClusterCountX +
+                          ::CellIndex(x, -GridHalfWidth, GridHalfWidth, ClusterCountX);
+
+        const auto influence = luminance * light.radius / (light.radius + nc::Magnitude(offset));
+
+        // Insertion into the cell's short, sorted list of its best lights
+        auto& cluster = m_clusters[cell];
+        auto& size = m_clusterSizes[cell];
+        auto position = size;
+        while (position > 0 && cluster[position - 1].influence < influence)
+        {
+            if (position < LightsPerCluster)
+                cluster[position] = cluster[position - 1];
+
+            --position;
+        }
+
+        if (position < LightsPerCluster)
+        {
+            cluster[position] = Candidate{influence, index, 0ull};
+            size = std::min<size_t>(size + 1, LightsPerCluster);
+        }
+    }
+
+    for (auto cell = 0ull; cell < ClusterCount; ++cell)
+    {
+        for (auto rank = 0ull; rank < m_clusterSizes[cell]; ++rank)
+        {
+            m_clusters[cell][rank].rank = rank;
+        }
+    }
+}
+
+void LightClusterer::AssignSlots(std::span<const Candidate> selected)
+{
+    auto isSelected = [&selected](size_t light)
+    {
+        return std::ranges::find(selected, light, &Candidate::light) != selected.end();
+    };
+
+    // Free slots whose light lost out, then place newly selected lights in them
+    for (auto& slotLight : m_slotLights)
+    {
+        if (slotLight != NoLight && !isSelected(slotLight))
+            slotLight = NoLight;
+    }
+
+    for (const auto& candidate : selected)
+    {
+        if (std::ranges::find(m_slotLights, candidate.light) != m_slotLights.end())
+            continue;
+
+        *std::ranges::find(m_slotLights, NoLight) = candidate.light;
+    }
+}
+} // namespace game
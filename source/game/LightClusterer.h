@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Core.h"
+
+namespace game
+{
+// Ambient rgb followed by diffuse rgb
+constexpr auto LightChannels = 6ull;
+
+// Lets the scene hold more point lights than the engine's maxPointLights. Lights are kept here as data, and each frame
+// they're binned into a grid laid out along the camera's view on the ground plane. Each cell keeps its most
+// influential lights, and the best of those across all cells are shown through a fixed set of real PointLights.
+// Lights that were already showing keep their slot, so a light only pops when it loses out.
+//
+// Level lights are adopted on the first frame - their PointLights are removed and replaced by the slots on the next.
+// Only used with gameplay enabled, so the editor never sees (or saves) a level without its lights.
+class LightClusterer : public nc::FreeComponent
+{
+    public:
+        static constexpr auto RealLightCount = 10ull; // BuildConfig's maxPointLights
+        static constexpr auto ClusterCountX = 4ull;
+        static constexpr auto ClusterCountZ = 4ull;
+        static constexpr auto ClusterCount = ClusterCountX * ClusterCountZ;
+        static constexpr auto LightsPerCluster = 2ull;
+        static constexpr auto GridHalfWidth = 60.0f;
+        static constexpr auto GridNear = -15.0f; // a bit behind the camera, it sits well back from what it looks at
+        static constexpr auto GridFar = 120.0f;
+
+        explicit LightClusterer(nc::Entity self);
+
+        void RegisterCamera(nc::Entity camera) { m_camera = camera; }
+
+        // Returns the light's index. 'source' is only used to find the light again later.
+        auto AddLight(const nc::Vector3& position, const nc::Vector3& ambient, const nc::Vector3& diffuse, float radius, nc::Entity source = nc::Entity::Null()) -> size_t;
+        void Adopt(nc::ecs::Ecs world);
+
+        auto Find(nc::Entity source) const -> size_t;
+        auto GetLightCount() const noexcept { return m_lights.size(); }
+        auto GetColor(size_t index) const -> std::span<const float, LightChannels>;
+        void SetColor(size_t index, std::span<const float, LightChannels> color);
+        auto GetShownLightCount() const noexcept { return m_shownCount; }
+
+        void Run(nc::Entity self, nc::Registry* registry, float dt);
+
+    private:
+        static constexpr auto NoLight = std::numeric_limits<size_t>::max();
+
+        struct VirtualLight
+        {
+            nc::Vector3 position;
+            float radius;
+            nc::Entity source;
+        };
+
+        struct Candidate
+        {
+            float influence;
+            size_t light;
+            size_t rank;
+        };
+
+        std::vector<VirtualLight> m_lights;
+        std::vector<float> m_colors;
+        std::array<std::array<Candidate, LightsPerCluster>, ClusterCount> m_clusters;
+        std::array<size_t, ClusterCount> m_clusterSizes{};
+        std::array<Candidate, ClusterCount * LightsPerCluster> m_candidates;
+        std::array<nc::Entity, RealLightCount> m_slots;
+        std::array<size_t, RealLightCount> m_slotLights;
+        nc::Entity m_camera = nc::Entity::Null();
+        size_t m_shownCount = 0ull;
+        bool m_adopted = false;
+        bool m_slotsCreated = false;
+
+        void CreateSlots(nc::ecs::Ecs world);
+        void Bin(const nc::Vector3& origin, const nc::Vector3& right, const nc::Vector3& forward);
+        void AssignSlots(std::span<const Candidate> selected);
+};
+} // namespace game
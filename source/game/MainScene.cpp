@@ -1,4 +1,6 @@
 #include "MainScene.h"
+#include "AnimationCrowd.h"
+#include "AssetResidency.h"
 #include "Assets.h"
 #include "Character.h"
 #include "Core.h"
@@ -6,20 +8,48 @@
 #include "Environment.h"
 #include "Event.h"
 #include "FollowCamera.h"
-#include "QuestTrigger.h"
+#include "GameInput.h"
+#include "GameplayOrchestrator.h"
+#include "InfectedTreeIndex.h"
+#include "LightAnimator.h"
+#include "LightClusterer.h"
+#include "ParticleBudget.h"
+#include "ParticleBurstPool.h"
+#include "ProximityTriggers.h"
 #include "Sasquatch.h"
+#include "ScenePatch.h"
 #include "Tree.h"
+#include "TriggerEventQueue.h"
+#include "VoiceManager.h"
 
 #include "ncengine/serialize/SceneSerialization.h"
 
 #include <fstream>
 
-void LoadBaseScene(nc::ecs::Ecs world, nc::asset::NcAsset* ncAsset, const std::string& path)
+namespace
 {
-    auto file = std::ifstream{path, std::ios::binary};
-    NC_ASSERT(file.is_open(), fmt::format("Scene fragment '{}' not found.", path));
-    nc::LoadSceneFragment(file, world, *ncAsset);
+const auto LevelPath = std::string{"scene/level"};
+
+// Save in-editor changes as a patch against the loaded level, or reload the scene to pick up the patch on disk. The
+// reload goes through a scene change, rather than patching in place, so entities are only ever removed and loaded
+// around the engine's own commits.
+void AttachScenePatchSaver(nc::ecs::Ecs world, game::SceneSnapshot base)
+{
+    auto saver = world.Emplace<nc::Entity>({.tag = "ScenePatchSaver", .flags = nc::Entity::Flags::NoSerialize});
+    world.Emplace<nc::FrameLogic>(saver, [base = std::move(base)](nc::Entity, nc::Registry* registry, float)
+    {
+        if (nc::input::KeyDown(game::hotkey::SaveScenePatch))
+        {
+            auto patch = std::ofstream{game::GetPatchPath(LevelPath), std::ios::binary | std::ios::trunc};
+            game::SaveScenePatch(patch, registry->GetEcs(), base);
+        }
+        else if (nc::input::KeyDown(game::hotkey::ReloadScenePatch))
+        {
+            game::GameplayOrchestrator::Instance().QueueSceneReload();
+        }
+    });
 }
+} // anonymous namespace
 
 namespace game
 {
@@ -31,6 +61,17 @@ void MainScene::Load(nc::Registry* registry, nc::ModuleProvider modules)
     auto ncAudio = modules.Get<nc::audio::NcAudio>();
     [[maybe_unused]] auto ncRandom = modules.Get<nc::Random>();
 
+    // Recorded and replayed sessions need the same world, not just the same keys
+    auto& input = GameInput::Instance();
+    if (const auto seed = input.GetSeed())
+        ncRandom->Seed(*seed);
+
+    // Emplaced first so it runs before any other FrameLogic and FixedLogic, and everything reads the same keys within
+    // a frame or tick
+    const auto inputSampler = world.Emplace<nc::Entity>({.tag = "InputSampler", .flags = nc::Entity::Flags::NoSerialize});
+    world.Emplace<nc::FrameLogic>(inputSampler, [&input, world](nc::Entity, nc::Registry*, float dt) { input.Latch(world, dt); });
+    world.Emplace<nc::FixedLogic>(inputSampler, [&input](nc::Entity, nc::Registry*) { input.Tick(); });
+
     if (EnableGameplay)
     {
         // Runs the GameplayOrchestrator loop
@@ -43,13 +84,63 @@ void MainScene::Load(nc::Registry* registry, nc::ModuleProvider modules)
     // this path while doing modifications. Once complete, backup the latest 'workspace/scene' directory somewhere in 'workspace/backup'
     // (backup 'workspace/prefab' too, if you changed anything) Then, save your temp scene from 'install/your_scene_name' to
     // 'workspace/scene/terrain' (or 'workspace/prefab/your_prefab').
+    // For small tweaks, skip all that and press F10 to save a patch instead. 'scene/level.patch' is applied on top of the
+    // level on load, and F11 reloads the scene to pick it up after editing the file. Fold it into the level and delete
+    // it once you're happy with the changes.
     auto ncAsset = modules.Get<nc::asset::NcAsset>();
-    ::LoadBaseScene(world, ncAsset, "scene/level");
+    [[maybe_unused]] auto levelSnapshot = LoadLevel(::LevelPath, registry, *ncAsset, !EnableGameplay);
+
+    const auto voiceManager = world.Emplace<nc::Entity>({.tag = tag::VoiceManager, .flags = nc::Entity::Flags::NoSerialize});
+    auto voices = world.Emplace<VoiceManager>(voiceManager, world);
+    world.Emplace<nc::FrameLogic>(voiceManager, nc::InvokeFreeComponent<VoiceManager>{});
+
+    const auto burstPool = world.Emplace<nc::Entity>({.tag = tag::ParticleBurstPool, .flags = nc::Entity::Flags::NoSerialize});
+    world.Emplace<ParticleBurstPool>(burstPool);
+    world.Emplace<nc::FrameLogic>(burstPool, nc::InvokeFreeComponent<ParticleBurstPool>{});
+
+    const auto particleBudget = world.Emplace<nc::Entity>({.tag = tag::ParticleBudget, .flags = nc::Entity::Flags::NoSerialize});
+    auto particles = world.Emplace<ParticleBudget>(particleBudget);
+    world.Emplace<nc::FrameLogic>(particleBudget, nc::InvokeFreeComponent<ParticleBudget>{});
+
+    // Clustering replaces the level's PointLights, which would then be missing from anything saved in the editor
+    auto lights = static_cast<LightClusterer*>(nullptr);
+    if constexpr (EnableGameplay)
+    {
+        const auto lightClusterer = world.Emplace<nc::Entity>({.tag = tag::LightClusterer, .flags = nc::Entity::Flags::NoSerialize});
+        lights = world.Emplace<LightClusterer>(lightClusterer);
+        world.Emplace<nc::FrameLogic>(lightClusterer, nc::InvokeFreeComponent<LightClusterer>{});
+    }
+
+    const auto lightAnimator = world.Emplace<nc::Entity>({.tag = tag::LightAnimator, .flags = nc::Entity::Flags::NoSerialize});
+    world.Emplace<LightAnimator>(lightAnimator);
+    world.Emplace<nc::FrameLogic>(lightAnimator, nc::InvokeFreeComponent<LightAnimator>{});
+
+    const auto animationCrowd = world.Emplace<nc::Entity>({.tag = tag::AnimationCrowd, .flags = nc::Entity::Flags::NoSerialize});
+    auto crowd = world.Emplace<AnimationCrowd>(animationCrowd);
+    world.Emplace<nc::FrameLogic>(animationCrowd, nc::InvokeFreeComponent<AnimationCrowd>{});
+
+    const auto infectedTreeIndex = world.Emplace<nc::Entity>({.tag = tag::InfectedTreeIndex, .flags = nc::Entity::Flags::NoSerialize});
+    world.Emplace<InfectedTreeIndex>(infectedTreeIndex);
+
+    const auto triggerEventQueue = world.Emplace<nc::Entity>({.tag = tag::TriggerEventQueue, .flags = nc::Entity::Flags::NoSerialize});
+    auto triggers = world.Emplace<TriggerEventQueue>(triggerEventQueue);
+    triggers->Subscribe(layer::HealthyTree, HandleHealthyTreeTriggers);
+    world.Emplace<nc::FixedLogic>(triggerEventQueue, nc::InvokeFreeComponent<TriggerEventQueue>{});
+
+    const auto proximityTriggers = world.Emplace<nc::Entity>({.tag = tag::ProximityTriggers, .flags = nc::Entity::Flags::NoSerialize});
+    auto storyTriggers = world.Emplace<ProximityTriggers>(proximityTriggers);
+    world.Emplace<nc::FixedLogic>(proximityTriggers, nc::InvokeFreeComponent<ProximityTriggers>{});
 
     const auto characterSpawnPos = nc::Vector3{120.0f, 0.0f, -136.0f};
-    const auto character = CreateCharacter(world, phys, characterSpawnPos);
+    const auto character = CreateCharacter(world, phys, voices, characterSpawnPos);
     const auto camera = CreateCamera(world, gfx, characterSpawnPos, character);
     ncAudio->RegisterListener(camera);
+    voices->RegisterListener(camera);
+    particles->RegisterCamera(camera);
+    if (lights)
+        lights->RegisterCamera(camera);
+    crowd->RegisterCamera(camera);
+    storyTriggers->RegisterPlayer(character);
 
     const auto firepit = world.Emplace<nc::Entity>(nc::EntityInfo
     {
@@ -84,8 +175,11 @@ void MainScene::Load(nc::Registry* registry, nc::ModuleProvider modules)
     world.Emplace<nc::graphics::ToonRenderer>(firepit, FirepitMesh, FirepitMaterial);
     world.Emplace<nc::physics::Collider>(firepit, nc::physics::SphereProperties{.center = nc::Vector3::Zero(), .radius = 1.7f}, false);
     world.Emplace<nc::graphics::ToonRenderer>(fire, FireMesh, FireMaterial);
-    world.Emplace<nc::graphics::SkeletalAnimator>(fire, FireMesh, FireFlicker);
-    world.Emplace<nc::graphics::PointLight>(fireLight, nc::Vector3{1.0f, 1.0f, 0.0f}, nc::Vector3{1.0f, 0.64f, 0.0f}, 10.0f);
+    crowd->Add(world, fire, FireMesh, FireFlicker);
+    if (lights)
+        lights->AddLight(world.Get<nc::Transform>(fireLight)->Position(), nc::Vector3{1.0f, 1.0f, 0.0f}, nc::Vector3{1.0f, 0.64f, 0.0f}, 10.0f, fireLight);
+    else
+        world.Emplace<nc::graphics::PointLight>(fireLight, nc::Vector3{1.0f, 1.0f, 0.0f}, nc::Vector3{1.0f, 0.64f, 0.0f}, 10.0f);
 
     const auto floor = world.Emplace<nc::Entity>(nc::EntityInfo
     {
@@ -106,19 +200,27 @@ void MainScene::Load(nc::Registry* registry, nc::ModuleProvider modules)
     const auto globalAudio = world.Emplace<nc::Entity>({.tag = "GlobalAudio", .flags = nc::Entity::Flags::NoSerialize});
     const auto ambience = world.Emplace<nc::Entity>({.parent = globalAudio, .tag = tag::AmbienceSfx, .flags = nc::Entity::Flags::NoSerialize});
     const auto introTheme = world.Emplace<nc::Entity>({.parent = globalAudio, .tag = tag::IntroThemeMusic, .flags = nc::Entity::Flags::NoSerialize});
-    const auto blightClearedMusic = world.Emplace<nc::Entity>({.parent = globalAudio, .tag = tag::BlightClearedMusic, .flags = nc::Entity::Flags::NoSerialize});
-    const auto loseMusic = world.Emplace<nc::Entity>({.parent = globalAudio, .tag = tag::LoseMusic, .flags = nc::Entity::Flags::NoSerialize});
-    const auto endingMusic = world.Emplace<nc::Entity>({.parent = globalAudio, .tag = tag::EndingMusic, .flags = nc::Entity::Flags::NoSerialize});
-    world.Emplace<nc::audio::AudioSource>(ambience, ForestAmbienceSfx, nc::audio::AudioSourceProperties{.gain = 0.3f, .loop = true})->Play();
-    world.Emplace<nc::audio::AudioSource>(introTheme, IntroThemeMusic, nc::audio::AudioSourceProperties{.gain = 0.4f, .loop = false})->Play();
-    world.Emplace<nc::audio::AudioSource>(blightClearedMusic, BlightClearedMusic, nc::audio::AudioSourceProperties{.gain = 0.4f, .loop = false});
-    world.Emplace<nc::audio::AudioSource>(loseMusic, LoseMusic, nc::audio::AudioSourceProperties{.gain = 0.4f, .loop = false});
-    world.Emplace<nc::audio::AudioSource>(endingMusic, EndingMusic, nc::audio::AudioSourceProperties{.gain = 0.4f, .loop = false});
+    world.Emplace<nc::Entity>({.parent = globalAudio, .tag = tag::BlightClearedMusic, .flags = nc::Entity::Flags::NoSerialize});
+    world.Emplace<nc::Entity>({.parent = globalAudio, .tag = tag::LoseMusic, .flags = nc::Entity::Flags::NoSerialize});
+    world.Emplace<nc::Entity>({.parent = globalAudio, .tag = tag::EndingMusic, .flags = nc::Entity::Flags::NoSerialize});
+    AssetResidency::Instance().Acquire(AssetType::AudioClip, ForestAmbienceSfx);
+    AssetResidency::Instance().Acquire(AssetType::AudioClip, IntroThemeMusic); // released by the orchestrator once finished
+    world.Emplace<nc::audio::AudioSource>(ambience, ForestAmbienceSfx, nc::audio::AudioSourceProperties{.gain = 0.3f, .loop = true});
+    world.Emplace<nc::audio::AudioSource>(introTheme, IntroThemeMusic, nc::audio::AudioSourceProperties{.gain = 0.4f, .loop = false});
+    voices->Play(ambience);
+    voices->Play(introTheme);
+    // Sources for the remaining music are added by the orchestrator once their clips are loaded
 
     //////////////////////////////////////////////////////
     // Debug environment - just to have stuff in the world
 #ifndef GAME_PROD_BUILD
     CreateDebugCamera(world, gfx); // MAKE SURE NOT IN FINAL BUILD
+
+    // Gameplay replaces serialized trees, so a patch saved with it enabled would be garbage
+    if constexpr (!EnableGameplay)
+    {
+        ::AttachScenePatchSaver(world, std::move(levelSnapshot));
+    }
 #endif
     // Spawning ops
 #if 0
@@ -0,0 +1,161 @@
+#include "ParticleBudget.h"
+
+namespace
+{
+auto LiveFactor(const nc::graphics::ParticleInfo& info) -> float
+{
+    // Period is 'periodicEmissionFrequency' - the engine emits once each time that many seconds pass
+    return info.init.lifetime / std::max(info.emission.periodicEmissionFrequency, 0.01f);
+}
+} // anonymous namespace
+
+namespace game
+{
+ParticleBudget::ParticleBudget(nc::Entity self)
+    : nc::FreeComponent{self}
+{
+}
+
+void ParticleBudget::Track(nc::Entity emitter, ParticleImportance importance, unsigned count)
+{
+    m_tracked.emplace_back(emitter, importance, count, count, 0u, 0.0f, 0.0f);
+}
+
+void ParticleBudget::Untrack(nc::Entity emitter)
+{
+    std::erase_if(m_tracked, [emitter](const Tracked& tracked) { return tracked.entity == emitter; });
+}
+
+void ParticleBudget::SetDesiredCount(nc::Entity emitter, unsigned count)
+{
+    auto pos = std::ranges::find(m_tracked, emitter, &Tracked::entity);
+    if (pos != m_tracked.end())
+        pos->desired = count;
+}
+
+auto ParticleBudget::RequestBurst(ParticleImportance importance, unsigned count, float lifetime, const nc::Vector3& position) -> unsigned
+{
+    auto wanted = static_cast<float>(count);
+    if (importance != ParticleImportance::Critical)
+    {
+        const auto headroom = std::max(MaxLiveParticles - m_liveEstimate, 0.0f);
+        wanted = std::min(wanted * DistanceScale(position) * m_tierScale[static_cast<size_t>(importance)], headroom);
+    }
+
+    const auto granted = static_cast<unsigned>(wanted);
+    if (granted > 0)
+    {
+        m_bursts.emplace_back(static_cast<float>(granted), lifetime);
+        m_liveEstimate += static_cast<float>(granted);
+    }
+
+    return granted;
+}
+
+void ParticleBudget::RefundBurst(unsigned count, float lifetime)
+{
+    // Nothing has aged since it was granted, so it's still the most recent burst with these values
+    const auto granted = static_cast<float>(count);
+    auto pos = std::ranges::find_if(m_bursts.rbegin(), m_bursts.rend(), [granted, lifetime](const Burst& burst)
+    {
+        return burst.count == granted && burst.remaining == lifetime;
+    });
+
+    if (pos == m_bursts.rend())
+        return;
+
+    m_liveEstimate = std::max(m_liveEstimate - granted, 0.0f);
+    m_bursts.erase(std::next(pos).base());
+}
+
+void ParticleBudget::Run(nc::Entity, nc::Registry* registry, float dt)
+{
+    std::erase_if(m_bursts, [dt](Burst& burst)
+    {
+        burst.remaining -= dt;
+        return burst.remaining <= 0.0f;
+    });
+
+    m_timeSinceEvaluate += dt;
+    if (m_timeSinceEvaluate < ReevaluateInterval)
+        return;
+
+    m_timeSinceEvaluate = 0.0f;
+    Evaluate(registry->GetEcs());
+}
+
+void ParticleBudget::Evaluate(nc::ecs::Ecs world)
+{
+    if (m_camera.Valid())
+        m_cameraPosition = world.Get<nc::Transform>(m_camera)->Position();
+
+    // Tracked emitters may not be committed yet on the first pass, so only drop them once they've gone missing twice.
+    // Removed emitters should already be untracked - this just keeps a missed Untrack from costing budget forever.
+    std::erase_if(m_tracked, [&world, this](Tracked& tracked)
+    {
+        const auto particles = world.Get<nc::graphics::ParticleEmitter>(tracked.entity);
+        if (!particles)
+        {
+            tracked.wanted = 0.0f;
+            return ++tracked.misses > 1;
+        }
+
+        tracked.misses = 0;
+        tracked.liveFactor = ::LiveFactor(particles->GetInfo());
+        tracked.wanted = static_cast<float>(tracked.desired) * DistanceScale(world.Get<nc::Transform>(tracked.entity)->Position());
+        return false;
+    });
+
+    auto remaining = MaxLiveParticles;
+    for (const auto& burst : m_bursts)
+    {
+        remaining -= burst.count;
+    }
+
+    remaining = std::max(remaining, 0.0f);
+    m_liveEstimate = MaxLiveParticles - remaining;
+    for (auto tier = TierCount; tier-- > 0;)
+    {
+        const auto importance = static_cast<ParticleImportance>(tier);
+        auto demand = 0.0f;
+        for (const auto& tracked : m_tracked)
+        {
+            if (tracked.importance == importance)
+                demand += tracked.wanted * tracked.liveFactor;
+        }
+
+        const auto scale = importance == ParticleImportance::Critical || demand <= remaining ? 1.0f : remaining / demand;
+        m_tierScale[tier] = scale;
+        for (auto& tracked : m_tracked)
+        {
+            if (tracked.importance != importance)
+                continue;
+
+            const auto granted = static_cast<unsigned>(tracked.wanted * scale);
+            m_liveEstimate += static_cast<float>(granted) * tracked.liveFactor;
+            if (granted == tracked.granted)
+                continue;
+
+            auto particles = world.Get<nc::graphics::ParticleEmitter>(tracked.entity);
+            if (!particles)
+                continue;
+
+            auto info = particles->GetInfo();
+            info.emission.periodicEmissionCount = granted;
+            particles->SetInfo(info);
+            tracked.granted = granted;
+        }
+
+        remaining = std::max(remaining - demand * scale, 0.0f);
+    }
+}
+
+auto ParticleBudget::DistanceScale(const nc::Vector3& position) const -> float
+{
+    if (!m_camera.Valid())
+        return 1.0f;
+
+    const auto distance = nc::Distance(position, m_cameraPosition);
+    return std::clamp(1.0f - (distance - NearDistance) / (FarDistance - NearDistance), 0.0f, 1.0f);
+}
+} // namespace game
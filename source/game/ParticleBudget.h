@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Core.h"
+
+namespace game
+{
+enum class ParticleImportance : uint8_t
+{
+    Background, // blight
+    Normal,     // morph bursts
+    Critical    // player feedback, i.e. the purify spray - never scaled
+};
+
+// Caps the estimated number of live particles across every emitter. Periodic emitters are tracked and ask for an
+// emission count, and bursts ask before they fire. Requests are scaled down by distance to the camera, then budget
+// goes to the most important requests first, with whatever's left shared evenly within the next tier down.
+class ParticleBudget : public nc::FreeComponent
+{
+    public:
+        static constexpr auto MaxLiveParticles = 4000.0f;
+        static constexpr auto NearDistance = 30.0f;  // full rate inside this
+        static constexpr auto FarDistance = 150.0f;  // nothing past this
+        static constexpr auto ReevaluateInterval = 0.25f;
+
+        explicit ParticleBudget(nc::Entity self);
+
+        void RegisterCamera(nc::Entity camera) { m_camera = camera; }
+
+        // Take over a periodic emitter's emission count, starting from the count it was created with
+        void Track(nc::Entity emitter, ParticleImportance importance, unsigned count);
+        void Untrack(nc::Entity emitter); // before removing it, so a reused handle isn't mistaken for it
+        void SetDesiredCount(nc::Entity emitter, unsigned count);
+
+        // Returns how many of 'count' particles a burst may emit, and charges them against the budget
+        auto RequestBurst(ParticleImportance importance, unsigned count, float lifetime, const nc::Vector3& position) -> unsigned;
+
+        // Give back a burst granted this frame that didn't fire after all
+        void RefundBurst(unsigned count, float lifetime);
+
+        void Run(nc::Entity self, nc::Registry* registry, float dt);
+
+        auto GetLiveEstimate() const noexcept { return m_liveEstimate; }
+
+    private:
+        struct Tracked
+        {
+            nc::Entity entity;
+            ParticleImportance importance;
+            unsigned desired;
+            unsigned granted;
+            unsigned misses;
+            float wanted;     // desired count after distance scaling
+            float liveFactor; // live particles per unit of emission count, i.e. lifetime / period
+        };
+
+        struct Burst
+        {
+            float count;
+            float remaining;
+        };
+
+        static constexpr auto TierCount = 3ull;
+
+        std::vector<Tracked> m_tracked;
+        std::vector<Burst> m_bursts;
+        std::array<float, TierCount> m_tierScale{1.0f, 1.0f, 1.0f};
+        nc::Vector3 m_cameraPosition;
+        nc::Entity m_camera = nc::Entity::Null();
+        float m_timeSinceEvaluate = ReevaluateInterval;
+        float m_liveEstimate = 0.0f;
+
+        void Evaluate(nc::ecs::Ecs world);
+        auto DistanceScale(const nc::Vector3& position) const -> float;
+};
+} // namespace game
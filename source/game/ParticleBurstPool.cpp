@@ -0,0 +1,107 @@
+#include "ParticleBurstPool.h"
+
+namespace game
+{
+ParticleBurstPool::ParticleBurstPool(nc::Entity self)
+    : nc::FreeComponent{self}
+{
+    m_emitters.reserve(MaxEmitters);
+}
+
+// Prefers an idle emitter with the same texture, then a new one while under MaxEmitters, then recycling an idle one with
+// another texture. With every emitter mid-burst, the burst doubles up on the same-texture emitter closest to finishing.
+auto ParticleBurstPool::Fire(nc::ecs::Ecs world, const nc::graphics::ParticleInfo& info, const nc::Vector3& position, unsigned count) -> bool
+{
+    const auto& texture = info.init.particleTexturePath;
+    auto idle = std::ranges::find_if(m_emitters, [&texture](const Emitter& emitter)
+    {
+        return emitter.remaining <= 0.0f && emitter.texture == texture;
+    });
+
+    if (idle != m_emitters.end())
+    {
+        Refire(world, *idle, info, position, count);
+        return true;
+    }
+
+    if (m_emitters.size() < MaxEmitters)
+    {
+        m_emitters.push_back(Create(world, info, position, count));
+        return true;
+    }
+
+    // Full - recycle an idle emitter with some other texture
+    idle = std::ranges::find_if(m_emitters, [](const Emitter& emitter) { return emitter.remaining <= 0.0f; });
+    if (idle != m_emitters.end())
+    {
+        // A burst still waiting on the old emitter would otherwise be refired from the new one
+        const auto index = static_cast<size_t>(std::distance(m_emitters.begin(), idle));
+        std::erase_if(m_deferred, [index](const Burst& burst) { return burst.emitter == index; });
+        world.Remove<nc::Entity>(idle->entity);
+        *idle = Create(world, info, position, count);
+        return true;
+    }
+
+    // Everything is mid-burst, so double up on the emitter closest to finishing rather than growing
+    auto oldest = std::ranges::min_element(m_emitters, {}, [&texture](const Emitter& emitter)
+    {
+        return emitter.texture == texture ? emitter.remaining : std::numeric_limits<float>::max();
+    });
+
+    if (oldest->texture != texture)
+        return false;
+
+    Refire(world, *oldest, info, position, count);
+    return true;
+}
+
+void ParticleBurstPool::Run(nc::Entity, nc::Registry* registry, float dt)
+{
+    auto world = registry->GetEcs();
+    m_retrying.swap(m_deferred);
+    for (const auto& burst : m_retrying)
+    {
+        Refire(world, m_emitters[burst.emitter], burst.info, burst.position, burst.count);
+    }
+
+    m_retrying.clear();
+    for (auto& emitter : m_emitters)
+    {
+        emitter.remaining -= dt;
+    }
+}
+
+void ParticleBurstPool::Refire(nc::ecs::Ecs world, Emitter& emitter, const nc::graphics::ParticleInfo& info, const nc::Vector3& position, unsigned count)
+{
+    emitter.remaining = info.init.lifetime;
+    auto particles = world.Get<nc::graphics::ParticleEmitter>(emitter.entity);
+    if (!particles)
+    {
+        const auto index = static_cast<size_t>(&emitter - m_emitters.data());
+        m_deferred.emplace_back(index, info, position, count);
+        return;
+    }
+
+    auto refireInfo = info;
+    refireInfo.emission = nc::graphics::ParticleEmissionInfo{};
+    world.Get<nc::Transform>(emitter.entity)->SetPosition(position);
+    particles->SetInfo(refireInfo);
+    particles->Emit(count);
+}
+
+auto ParticleBurstPool::Create(nc::ecs::Ecs world, const nc::graphics::ParticleInfo& info, const nc::Vector3& position, unsigned count) -> Emitter
+{
+    const auto entity = world.Emplace<nc::Entity>({
+        .position = position,
+        .parent = ParentEntity(),
+        .tag = "BurstEmitter",
+        .flags = nc::Entity::Flags::NoSerialize
+    });
+
+    // New emitters aren't registered until the end of the frame, so their first burst goes through the initial emission
+    auto createInfo = info;
+    createInfo.emission = nc::graphics::ParticleEmissionInfo{.initialEmissionCount = count};
+    world.Emplace<nc::graphics::ParticleEmitter>(entity, createInfo);
+    return Emitter{entity, info.init.particleTexturePath, info.init.lifetime};
+}
+} // namespace game
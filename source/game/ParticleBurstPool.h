@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Core.h"
+
+namespace game
+{
+// One-shot particle bursts played from a fixed set of reusable emitters. An emitter is busy until the particles from
+// its last burst have expired, then goes back to the pool, so the emitter count stays bounded however often bursts fire.
+class ParticleBurstPool : public nc::FreeComponent
+{
+    public:
+        static constexpr auto MaxEmitters = 16ull;
+
+        explicit ParticleBurstPool(nc::Entity self);
+
+        // Emits 'count' particles at 'position'. Emission settings in 'info' are ignored. Returns false if the burst was
+        // dropped, which only happens when every emitter is mid-burst with some other texture.
+        auto Fire(nc::ecs::Ecs world, const nc::graphics::ParticleInfo& info, const nc::Vector3& position, unsigned count) -> bool;
+
+        void Run(nc::Entity self, nc::Registry* registry, float dt);
+
+        auto GetEmitterCount() const noexcept { return m_emitters.size(); }
+        auto GetBusyEmitterCount() const noexcept
+        {
+            return std::ranges::count_if(m_emitters, [](const Emitter& emitter) { return emitter.remaining > 0.0f; });
+        }
+
+    private:
+        // An emitter's texture is fixed once created, so emitters are only reused for the texture they were created with
+        struct Emitter
+        {
+            nc::Entity entity;
+            std::string texture;
+            float remaining;
+        };
+
+        // A burst doubled up on an emitter created this frame, which can't be refired until it's committed
+        struct Burst
+        {
+            size_t emitter;
+            nc::graphics::ParticleInfo info;
+            nc::Vector3 position;
+            unsigned count;
+        };
+
+        std::vector<Emitter> m_emitters;
+        std::vector<Burst> m_deferred;
+        std::vector<Burst> m_retrying;
+
+        void Refire(nc::ecs::Ecs world, Emitter& emitter, const nc::graphics::ParticleInfo& info, const nc::Vector3& position, unsigned count);
+        auto Create(nc::ecs::Ecs world, const nc::graphics::ParticleInfo& info, const nc::Vector3& position, unsigned count) -> Emitter;
+};
+} // namespace game
@@ -0,0 +1,101 @@
+#include "ProximityTriggers.h"
+
+namespace
+{
+// The box is centered on 'center' with its axes along 'right', 'up' and 'forward'
+auto Touches(const nc::Vector3& point, float radius, const nc::Vector3& center, const nc::Vector3& halfExtents,
+             const nc::Vector3& right, const nc::Vector3& up, const nc::Vector3& forward) -> bool
+{
+    const auto offset = point - center;
+    const auto local = nc::Vector3{nc::Dot(offset, right), nc::Dot(offset, up), nc::Dot(offset, forward)};
+    const auto closest = nc::Vector3{
+        nc::Clamp(local.x, -halfExtents.x, halfExtents.x),
+        nc::Clamp(local.y, -halfExtents.y, halfExtents.y),
+        nc::Clamp(local.z, -halfExtents.z, halfExtents.z)
+    };
+
+    return nc::SquareDistance(local, closest) <= radius * radius;
+}
+
+// 'center' is in the anchor's local space
+auto WorldCenter(const nc::Vector3& center, const nc::Transform& anchor) -> nc::Vector3
+{
+    const auto offset = nc::HadamardProduct(center, anchor.Scale());
+    return anchor.Position() + anchor.Right() * offset.x + anchor.Up() * offset.y + anchor.Forward() * offset.z;
+}
+} // anonymous namespace
+
+namespace game
+{
+ProximityTriggers::ProximityTriggers(nc::Entity self)
+    : nc::FreeComponent{self}
+{
+}
+
+void ProximityTriggers::Add(nc::Entity anchor, const nc::Vector3& center, const nc::Vector3& extents, Event onEnter, nc::Entity indicator)
+{
+    m_volumes.emplace_back(anchor, center, extents * 0.5f, indicator, onEnter);
+}
+
+auto ProximityTriggers::FindNearest(nc::ecs::Ecs world, const nc::Vector3& position) const -> std::optional<nc::Vector3>
+{
+    auto nearest = std::optional<nc::Vector3>{};
+    auto nearestDistance = std::numeric_limits<float>::max();
+    for (const auto& volume : m_volumes)
+    {
+        const auto anchor = world.Get<nc::Transform>(volume.anchor);
+        if (!anchor)
+            continue;
+
+        const auto center = ::WorldCenter(volume.center, *anchor);
+        if (const auto distance = nc::SquareDistance(position, center); distance < nearestDistance)
+        {
+            nearest = center;
+            nearestDistance = distance;
+        }
+    }
+
+    return nearest;
+}
+
+void ProximityTriggers::Run(nc::Entity, nc::Registry* registry)
+{
+    if (!m_player.Valid() || m_volumes.empty())
+        return;
+
+    auto world = registry->GetEcs();
+    const auto player = world.Get<nc::Transform>(m_player)->Position();
+    for (auto i = 0ull; i < m_volumes.size();)
+    {
+        const auto& volume = m_volumes[i];
+        const auto anchor = world.Get<nc::Transform>(volume.anchor);
+        if (anchor)
+        {
+            const auto scale = anchor->Scale();
+            const auto right = anchor->Right();
+            const auto up = anchor->Up();
+            const auto forward = anchor->Forward();
+            const auto center = ::WorldCenter(volume.center, *anchor);
+            if (!::Touches(player, PlayerRadius, center, nc::HadamardProduct(volume.halfExtents, scale), right, up, forward))
+            {
+                ++i;
+                continue;
+            }
+
+            m_fired.push_back(volume.onEnter);
+        }
+
+        // Fired, or its anchor is gone - either way it's done
+        world.Remove<nc::Entity>(volume.indicator);
+        m_volumes[i] = m_volumes.back();
+        m_volumes.pop_back();
+    }
+
+    for (auto event : m_fired)
+    {
+        FireEvent(event);
+    }
+
+    m_fired.clear();
+}
+} // namespace game
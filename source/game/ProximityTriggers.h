@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Core.h"
+#include "Event.h"
+
+#include <optional>
+
+namespace game
+{
+// Story triggers, tested against the player's position each fixed step instead of through physics. Volumes are boxes
+// kept in a small packed array, placed relative to an anchor entity so they follow it as it moves and turns. Each fires its
+// event once, the first step the player touches it, and is then removed along with its indicator.
+class ProximityTriggers : public nc::FreeComponent
+{
+    public:
+        static constexpr auto PlayerRadius = 1.0f; // about the bus front's half-length
+
+        explicit ProximityTriggers(nc::Entity self);
+
+        void RegisterPlayer(nc::Entity player) { m_player = player; }
+
+        // 'center' is in the anchor's local space and 'extents' is the full size, both scaled with the anchor
+        void Add(nc::Entity anchor, const nc::Vector3& center, const nc::Vector3& extents, Event onEnter, nc::Entity indicator);
+        auto GetCount() const noexcept { return m_volumes.size(); }
+
+        // Center of the closest volume to 'position', if there are any
+        auto FindNearest(nc::ecs::Ecs world, const nc::Vector3& position) const -> std::optional<nc::Vector3>;
+
+        void Run(nc::Entity self, nc::Registry* registry);
+
+    private:
+        struct Volume
+        {
+            nc::Entity anchor;
+            nc::Vector3 center;
+            nc::Vector3 halfExtents;
+            nc::Entity indicator;
+            Event onEnter;
+        };
+
+        std::vector<Volume> m_volumes;
+        std::vector<Event> m_fired; // so events that add triggers don't invalidate the volumes being tested
+        nc::Entity m_player = nc::Entity::Null();
+};
+} // namespace game
@@ -3,14 +3,15 @@
 #include "Assets.h"
 #include "Core.h"
 #include "Event.h"
+#include "ProximityTriggers.h"
 
 namespace game
 {
-inline auto AttachQuestTrigger(nc::ecs::Ecs world,
+inline void AttachQuestTrigger(nc::ecs::Ecs world,
                                nc::Entity parent,
                                Event onPlayerHit,
                                const nc::Vector3& center = nc::Vector3::Zero(),
-                               const nc::Vector3& extents = nc::Vector3::One()) -> nc::Entity
+                               const nc::Vector3& extents = nc::Vector3::One())
 {
     const auto rootTransform = world.Get<nc::Transform>(parent);
     NC_ASSERT(rootTransform, "expected valid root transform");
@@ -41,28 +42,7 @@ inline auto AttachQuestTrigger(nc::ecs::Ecs world,
         }
     });
 
-    auto trigger = world.Emplace<nc::Entity>({
-        .parent = parent,
-        .tag = tag::QuestTrigger,
-        .layer = layer::QuestTrigger,
-        .flags = nc::Entity::Flags::NoSerialize | nc::Entity::Flags::Static
-    });
-
-    world.Emplace<nc::physics::Collider>(trigger, nc::physics::BoxProperties{.center = center, .extents = extents}, true);
-    auto triggerHandler = [onPlayerHit, triggerIndicator](nc::Entity self, nc::Entity other, nc::Registry* registry)
-    {
-        if (other.Layer() != layer::Character)
-            return;
-
-        FireEvent(onPlayerHit);
-        registry->Remove<nc::Entity>(self);
-        registry->Remove<nc::Entity>(triggerIndicator);
-    };
-
-    world.Emplace<nc::CollisionLogic>(trigger, nullptr, nullptr, triggerHandler, nullptr);
-
-
-
-    return trigger;
+    auto triggers = GetComponentByEntityTag<ProximityTriggers>(world, tag::ProximityTriggers);
+    triggers->Add(parent, center, extents, onPlayerHit, triggerIndicator);
 }
 } // namespace game
@@ -1,4 +1,5 @@
 #include "Sasquatch.h"
+#include "AnimationCrowd.h"
 #include "Assets.h"
 #include "QuestTrigger.h"
 
@@ -6,60 +7,37 @@ namespace game
 {
 void AttachSasquatchAnimators(nc::ecs::Ecs world)
 {
-    {
-        const auto dave = world.GetEntityByTag(tag::Dave);
-        world.Emplace<nc::graphics::SkeletalAnimator>(dave, DaveMesh, DaveIdle);
-    }
-
-    {
-        const auto camp = world.GetEntityByTag(tag::Camp);
-        world.Emplace<nc::graphics::SkeletalAnimator>(camp, DaveMesh, DaveIdle);
-    }
-
-    {
-        const auto elder = world.GetEntityByTag(tag::Elder);
-        world.Emplace<nc::graphics::SkeletalAnimator>(elder, DaveMesh, DaveIdle);
-    }
-
-    {
-        const auto putter = world.GetEntityByTag(tag::Putter);
-        world.Emplace<nc::graphics::SkeletalAnimator>(putter, DaveMesh, DaveIdle);
-    }
-
-    {
-        const auto s1 = world.GetEntityByTag(tag::Sasquatch1);
-        world.Emplace<nc::graphics::SkeletalAnimator>(s1, DaveMesh, DaveSittingGround);
-
-        const auto s2 = world.GetEntityByTag(tag::Sasquatch2);
-        world.Emplace<nc::graphics::SkeletalAnimator>(s2, DaveMesh, DaveSittingStump);
-
-        const auto s3 = world.GetEntityByTag(tag::Sasquatch3);
-        world.Emplace<nc::graphics::SkeletalAnimator>(s3, DaveMesh, DaveCircleWalk);
-    }
+    auto crowd = GetComponentByEntityTag<AnimationCrowd>(world, tag::AnimationCrowd);
+    crowd->Add(world, world.GetEntityByTag(tag::Dave), DaveMesh, DaveIdle);
+    crowd->Add(world, world.GetEntityByTag(tag::Camp), DaveMesh, DaveIdle);
+    crowd->Add(world, world.GetEntityByTag(tag::Elder), DaveMesh, DaveIdle);
+    crowd->Add(world, world.GetEntityByTag(tag::Putter), DaveMesh, DaveIdle);
+    crowd->Add(world, world.GetEntityByTag(tag::Sasquatch1), DaveMesh, DaveSittingGround);
+    crowd->Add(world, world.GetEntityByTag(tag::Sasquatch2), DaveMesh, DaveSittingStump);
+    crowd->Add(world, world.GetEntityByTag(tag::Sasquatch3), DaveMesh, DaveCircleWalk);
 }
 
 void SetAnimatorState(nc::ecs::Ecs world, std::string_view animation, std::string_view tag)
 {
-    const auto entity = world.GetEntityByTag(tag);
-    auto animator = world.Get<nc::graphics::SkeletalAnimator>(entity);
-    NC_ASSERT(animator, "expected entity to have an animator");
-    animator->LoopImmediate(std::string{animation}, [](){ return false; });
+    auto crowd = GetComponentByEntityTag<AnimationCrowd>(world, tag::AnimationCrowd);
+    crowd->Loop(world, world.GetEntityByTag(tag), animation);
 }
 
 void SetPlayOnceAnimation(nc::ecs::Ecs world, std::string_view animation, std::string_view tag)
 {
-    const auto entity = world.GetEntityByTag(tag);
-    auto animator = world.Get<nc::graphics::SkeletalAnimator>(entity);
-    NC_ASSERT(animator, "expected entity to have an animator");
-    animator->PlayOnceImmediate(std::string{animation});
+    auto crowd = GetComponentByEntityTag<AnimationCrowd>(world, tag::AnimationCrowd);
+    crowd->PlayOnce(world, world.GetEntityByTag(tag), animation);
 }
 
 void ReturnAnimatorToRootState(nc::ecs::Ecs world, std::string_view tag)
 {
-    const auto entity = world.GetEntityByTag(tag);
-    auto animator = world.Get<nc::graphics::SkeletalAnimator>(entity);
-    NC_ASSERT(animator, "expected entity to have an animator");
-    animator->StopImmediate([](){ return true; });
+    auto crowd = GetComponentByEntityTag<AnimationCrowd>(world, tag::AnimationCrowd);
+    crowd->ReturnToRoot(world, world.GetEntityByTag(tag));
+}
+
+void ReleaseAnimations(nc::ecs::Ecs world)
+{
+    GetComponentByEntityTag<AnimationCrowd>(world, tag::AnimationCrowd)->Release();
 }
 
 void MoveSasquatchToCamp(nc::ecs::Ecs world)
@@ -10,6 +10,9 @@ void SetAnimatorState(nc::ecs::Ecs world, std::string_view animation, std::strin
 void SetPlayOnceAnimation(nc::ecs::Ecs world, std::string_view animation, std::string_view tag);
 void ReturnAnimatorToRootState(nc::ecs::Ecs world, std::string_view tag);
 
+// Drop the animation crowd's clip holds, when the scene is torn down
+void ReleaseAnimations(nc::ecs::Ecs world);
+
 void MoveSasquatchToCamp(nc::ecs::Ecs world);
 
 void AttachDaveQuestTrigger(nc::ecs::Ecs world);
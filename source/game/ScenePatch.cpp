@@ -0,0 +1,397 @@
+#include "ScenePatch.h"
+
+#include "ncengine/ecs/Tag.h"
+#include "ncengine/serialize/SceneSerialization.h"
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+constexpr auto PatchMagic = uint32_t{0x5053434e}; // 'NCSP'
+constexpr auto PatchVersion = uint32_t{2};
+constexpr auto IdentityEpsilon = 0.0001f;
+
+// Base fragments don't usually change while iterating on a patch, so they're only read from disk again once the file
+// has been written since. The same goes for their snapshots, which mean serializing the whole level to take.
+struct CachedLevel
+{
+    std::filesystem::file_time_type writeTime;
+    std::string bytes;
+    std::optional<game::SceneSnapshot> snapshot;
+};
+
+auto g_levelCache = std::unordered_map<std::string, CachedLevel>{};
+
+auto NearlyEqual(const nc::Vector3& lhs, const nc::Vector3& rhs) -> bool
+{
+    return std::abs(lhs.x - rhs.x) < IdentityEpsilon
+        && std::abs(lhs.y - rhs.y) < IdentityEpsilon
+        && std::abs(lhs.z - rhs.z) < IdentityEpsilon;
+}
+
+auto NearlyEqual(const nc::Quaternion& lhs, const nc::Quaternion& rhs) -> bool
+{
+    return std::abs(lhs.x - rhs.x) < IdentityEpsilon
+        && std::abs(lhs.y - rhs.y) < IdentityEpsilon
+        && std::abs(lhs.z - rhs.z) < IdentityEpsilon
+        && std::abs(lhs.w - rhs.w) < IdentityEpsilon;
+}
+
+auto SameIdentity(const game::EntityIdentity& lhs, const game::EntityIdentity& rhs) -> bool
+{
+    return lhs.layer == rhs.layer
+        && lhs.tag == rhs.tag
+        && NearlyEqual(lhs.position, rhs.position)
+        && NearlyEqual(lhs.rotation, rhs.rotation)
+        && NearlyEqual(lhs.scale, rhs.scale);
+}
+
+auto Identify(nc::ecs::Ecs world, nc::Entity entity) -> game::EntityIdentity
+{
+    const auto tag = world.Get<nc::Tag>(entity);
+    const auto transform = world.Get<nc::Transform>(entity);
+    NC_ASSERT(tag && transform, "expected entity to have a tag and transform");
+    return game::EntityIdentity{
+        .tag = std::string{tag->Value()},
+        .layer = entity.Layer(),
+        .position = transform->Position(),
+        .rotation = transform->Rotation(),
+        .scale = transform->Scale()
+    };
+}
+
+void VisitHierarchy(nc::ecs::Ecs world, nc::Entity root, const std::function<void(nc::Entity)>& visit)
+{
+    visit(root);
+    for (auto child : world.Get<nc::Transform>(root)->Children())
+    {
+        if (child.IsSerializable())
+            VisitHierarchy(world, child, visit);
+    }
+}
+
+auto GetSerializableRoots(nc::ecs::Ecs world) -> std::vector<nc::Entity>
+{
+    auto roots = std::vector<nc::Entity>{};
+    for (auto entity : world.GetAll<nc::Entity>())
+    {
+        if (entity.IsSerializable() && !world.Get<nc::Transform>(entity)->Parent().Valid())
+            roots.push_back(entity);
+    }
+
+    return roots;
+}
+
+// Serialized on its own, entities get fragment-local ids, so an untouched hierarchy gives the same bytes every time
+auto SerializeHierarchy(nc::ecs::Ecs world, nc::Entity root) -> std::string
+{
+    auto members = std::unordered_set<nc::Entity::index_type>{};
+    VisitHierarchy(world, root, [&members](nc::Entity entity) { members.insert(entity.Index()); });
+    auto stream = std::ostringstream{std::ios::binary};
+    nc::SaveSceneFragment(stream, world, nc::asset::AssetMap{}, [&members](nc::Entity entity)
+    {
+        return members.contains(entity.Index());
+    });
+
+    return std::move(stream).str();
+}
+
+// Pairs each root with an identical, not yet paired, base hierarchy. Returns the base index for each root, or NoMatch.
+constexpr auto NoMatch = std::numeric_limits<size_t>::max();
+
+auto MatchHierarchies(nc::ecs::Ecs world, std::span<const nc::Entity> roots, const game::SceneSnapshot& base) -> std::vector<size_t>
+{
+    auto unmatched = std::unordered_map<std::string_view, std::vector<size_t>>{};
+    for (auto i = base.hierarchies.size(); i > 0; --i)
+    {
+        unmatched[base.hierarchies[i - 1].bytes].push_back(i - 1); // reversed, so pairs are taken in load order
+    }
+
+    auto matches = std::vector<size_t>{};
+    matches.reserve(roots.size());
+    for (auto root : roots)
+    {
+        auto pos = unmatched.find(::SerializeHierarchy(world, root));
+        if (pos == unmatched.end() || pos->second.empty())
+        {
+            matches.push_back(NoMatch);
+            continue;
+        }
+
+        matches.push_back(pos->second.back());
+        pos->second.pop_back();
+    }
+
+    return matches;
+}
+
+template<class T>
+void Write(std::ostream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+auto RemainingBytes(std::istream& stream) -> size_t
+{
+    const auto pos = stream.tellg();
+    stream.seekg(0, std::ios::end);
+    const auto end = stream.tellg();
+    stream.seekg(pos);
+    if (!stream || pos < 0 || end < pos)
+        throw nc::NcError("Unable to size scene patch");
+
+    return static_cast<size_t>(end - pos);
+}
+
+template<class T>
+auto Read(std::istream& stream) -> T
+{
+    auto value = T{};
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!stream)
+        throw nc::NcError("Unexpected end of scene patch");
+
+    return value;
+}
+
+void WriteIdentity(std::ostream& stream, const game::EntityIdentity& identity)
+{
+    Write(stream, identity.layer);
+    Write(stream, static_cast<uint32_t>(identity.tag.size()));
+    stream.write(identity.tag.data(), static_cast<std::streamsize>(identity.tag.size()));
+    Write(stream, identity.position);
+    Write(stream, identity.rotation);
+    Write(stream, identity.scale);
+}
+
+auto ReadIdentity(std::istream& stream) -> game::EntityIdentity
+{
+    auto identity = game::EntityIdentity{};
+    identity.layer = Read<nc::Entity::layer_type>(stream);
+    const auto tagSize = Read<uint32_t>(stream);
+    if (tagSize > ::RemainingBytes(stream))
+        throw nc::NcError("Scene patch tag runs past the end of the patch");
+
+    identity.tag.resize(tagSize);
+    stream.read(identity.tag.data(), static_cast<std::streamsize>(identity.tag.size()));
+    identity.position = Read<nc::Vector3>(stream);
+    identity.rotation = Read<nc::Quaternion>(stream);
+    identity.scale = Read<nc::Vector3>(stream);
+    return identity;
+}
+
+// Base hierarchies to remove, by their index in the base snapshot - identity alone is ambiguous when two roots match
+struct Removal
+{
+    uint32_t index;
+    game::EntityIdentity root;
+};
+
+auto ReadRemovals(std::istream& stream) -> std::vector<Removal>
+{
+    if (Read<uint32_t>(stream) != PatchMagic)
+        throw nc::NcError("Invalid scene patch");
+
+    if (const auto version = Read<uint32_t>(stream); version != PatchVersion)
+        throw nc::NcError(fmt::format("Unsupported scene patch version '{}'", version));
+
+    // Each removal is at least an index, a layer, a tag size and a transform
+    constexpr auto minRemovalSize = sizeof(uint32_t) * 2 + sizeof(nc::Entity::layer_type) + sizeof(nc::Vector3) * 2 + sizeof(nc::Quaternion);
+    const auto removalCount = Read<uint32_t>(stream);
+    if (removalCount > ::RemainingBytes(stream) / minRemovalSize)
+        throw nc::NcError("Scene patch removal count runs past the end of the patch");
+
+    auto removals = std::vector<Removal>{};
+    removals.reserve(removalCount);
+    for (auto i = 0u; i < removalCount; ++i)
+    {
+        const auto index = Read<uint32_t>(stream);
+        removals.emplace_back(index, ReadIdentity(stream));
+    }
+
+    return removals;
+}
+
+auto GetCachedLevel(const std::string& path) -> CachedLevel&
+{
+    auto error = std::error_code{};
+    const auto writeTime = std::filesystem::last_write_time(path, error);
+    if (error)
+        throw nc::NcError(fmt::format("Scene fragment '{}' not found.", path));
+
+    if (auto pos = g_levelCache.find(path); pos != g_levelCache.end() && pos->second.writeTime == writeTime)
+        return pos->second;
+
+    auto file = std::ifstream{path, std::ios::binary};
+    if (!file.is_open())
+        throw nc::NcError(fmt::format("Scene fragment '{}' not found.", path));
+
+    auto bytes = std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    return g_levelCache.insert_or_assign(path, CachedLevel{writeTime, std::move(bytes), std::nullopt}).first->second;
+}
+
+// Removes everything loaded since 'before' was taken. Only roots are removed, which takes their children with them.
+void RemoveAddedEntities(nc::Registry* registry, const std::unordered_set<nc::Entity::index_type>& before)
+{
+    registry->CommitStagedChanges();
+    auto world = registry->GetEcs();
+    auto added = std::vector<nc::Entity>{};
+    for (auto entity : world.GetAll<nc::Entity>())
+    {
+        if (before.contains(entity.Index()))
+            continue;
+
+        const auto parent = world.Get<nc::Transform>(entity)->Parent();
+        if (!parent.Valid() || before.contains(parent.Index()))
+            added.push_back(entity);
+    }
+
+    for (auto entity : added)
+    {
+        world.Remove<nc::Entity>(entity);
+    }
+}
+} // anonymous namespace
+
+namespace game
+{
+auto TakeSceneSnapshot(nc::ecs::Ecs world) -> SceneSnapshot
+{
+    auto snapshot = SceneSnapshot{};
+    for (auto root : ::GetSerializableRoots(world))
+    {
+        snapshot.hierarchies.emplace_back(::Identify(world, root), ::SerializeHierarchy(world, root));
+    }
+
+    return snapshot;
+}
+
+void SaveScenePatch(std::ostream& stream, nc::ecs::Ecs world, const SceneSnapshot& base)
+{
+    const auto roots = ::GetSerializableRoots(world);
+    const auto matches = ::MatchHierarchies(world, roots, base);
+    auto baseMatched = std::vector<bool>(base.hierarchies.size(), false);
+    auto changed = std::unordered_set<nc::Entity::index_type>{};
+    for (auto i = 0ull; i < roots.size(); ++i)
+    {
+        if (matches[i] != ::NoMatch)
+            baseMatched[matches[i]] = true;
+        else
+            ::VisitHierarchy(world, roots[i], [&changed](nc::Entity entity) { changed.insert(entity.Index()); });
+    }
+
+    // Anything left over in the base was removed or modified; either way, the old version goes
+    auto removalCount = 0u;
+    for (auto matched : baseMatched)
+    {
+        removalCount += matched ? 0u : 1u;
+    }
+
+    ::Write(stream, PatchMagic);
+    ::Write(stream, PatchVersion);
+    ::Write(stream, removalCount);
+    for (auto i = 0ull; i < base.hierarchies.size(); ++i)
+    {
+        if (baseMatched[i])
+            continue;
+
+        ::Write(stream, static_cast<uint32_t>(i));
+        ::WriteIdentity(stream, base.hierarchies[i].root);
+    }
+
+    nc::SaveSceneFragment(stream, world, nc::asset::AssetMap{}, [&changed](nc::Entity entity)
+    {
+        return changed.contains(entity.Index());
+    });
+
+    NC_LOG_INFO(fmt::format("Saved scene patch: {} removed/modified, {} entities written", removalCount, changed.size()));
+}
+
+auto LoadScenePatch(std::istream& stream, nc::Registry* registry, nc::asset::NcAsset& ncAsset) -> bool
+{
+    auto removals = std::vector<::Removal>{};
+    try
+    {
+        removals = ::ReadRemovals(stream);
+    }
+    catch (const nc::NcError& e)
+    {
+        NC_LOG_WARNING(fmt::format("Skipping scene patch: {}", e.what()));
+        return false;
+    }
+
+    registry->CommitStagedChanges(); // base components need to be visible before matching against them
+    auto world = registry->GetEcs();
+    const auto roots = ::GetSerializableRoots(world);
+    const auto stale = std::ranges::find_if(removals, [&roots, world](const ::Removal& removal)
+    {
+        return removal.index >= roots.size() || !::SameIdentity(removal.root, ::Identify(world, roots[removal.index]));
+    });
+
+    // The level was re-saved since the patch was taken, so nothing it says can be trusted. Check everything before
+    // removing anything, so the base is left intact.
+    if (stale != removals.end())
+    {
+        NC_LOG_WARNING(fmt::format("Skipping scene patch: entity '{}' not found in base scene", stale->root.tag));
+        return false;
+    }
+
+    // Load what the patch adds before removing anything, so a corrupt fragment can be backed out without having touched
+    // the base
+    auto before = std::unordered_set<nc::Entity::index_type>{};
+    for (auto entity : world.GetAll<nc::Entity>())
+    {
+        before.insert(entity.Index());
+    }
+
+    try
+    {
+        nc::LoadSceneFragment(stream, world, ncAsset);
+    }
+    catch (const std::exception& e)
+    {
+        ::RemoveAddedEntities(registry, before);
+        NC_LOG_WARNING(fmt::format("Skipping scene patch: {}", e.what()));
+        return false;
+    }
+
+    for (const auto& removal : removals)
+    {
+        world.Remove<nc::Entity>(roots[removal.index]);
+    }
+
+    return true;
+}
+
+auto LoadLevel(const std::string& path, nc::Registry* registry, nc::asset::NcAsset& ncAsset, bool snapshot) -> SceneSnapshot
+{
+    auto world = registry->GetEcs();
+    auto& level = ::GetCachedLevel(path);
+    auto base = std::istringstream{level.bytes, std::ios::binary};
+    nc::LoadSceneFragment(base, world, ncAsset);
+    registry->CommitStagedChanges();
+    auto out = SceneSnapshot{};
+    if (snapshot)
+    {
+        if (!level.snapshot)
+            level.snapshot = TakeSceneSnapshot(world);
+
+        out = *level.snapshot;
+    }
+
+    if (auto patch = std::ifstream{GetPatchPath(path), std::ios::binary})
+    {
+        LoadScenePatch(patch, registry, ncAsset);
+    }
+
+    return out;
+}
+} // namespace game
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Core.h"
+
+#include <iosfwd>
+
+namespace game
+{
+// Entity handles aren't stable across editor saves, so patches check the roots they remove by what survives a round trip
+struct EntityIdentity
+{
+    std::string tag;
+    nc::Entity::layer_type layer = layer::None;
+    nc::Vector3 position = nc::Vector3::Zero();
+    nc::Quaternion rotation = nc::Quaternion::Identity();
+    nc::Vector3 scale = nc::Vector3::One();
+};
+
+// Every serializable hierarchy in a scene, in the order their roots were loaded. A hierarchy is the unit of change: if
+// anything in it was modified, the whole thing is replaced when patching. Each is kept serialized on its own, which is
+// what edits are detected against.
+struct SceneSnapshot
+{
+    struct Hierarchy
+    {
+        EntityIdentity root;
+        std::string bytes;
+    };
+
+    std::vector<Hierarchy> hierarchies;
+};
+
+auto TakeSceneSnapshot(nc::ecs::Ecs world) -> SceneSnapshot;
+
+// Write a patch that turns the 'base' snapshot into the current serializable state of world. Only hierarchies that were
+// added, removed, or changed in any component are written, so the patch stays small relative to the full fragment.
+void SaveScenePatch(std::ostream& stream, nc::ecs::Ecs world, const SceneSnapshot& base);
+
+// Apply a patch on top of a freshly loaded base fragment. A patch that doesn't match the base - because the level was
+// saved again since, or the patch is from an older version or corrupt - is skipped with a warning, leaving the base as it
+// was.
+auto LoadScenePatch(std::istream& stream, nc::Registry* registry, nc::asset::NcAsset& ncAsset) -> bool;
+
+// Load the base fragment at 'path', reusing bytes cached from previous loads unless the file has been written since, then
+// apply '<path>.patch' if one exists.
+// When 'snapshot' is set, returns a snapshot of the base so edits can later be saved as a patch against it - otherwise
+// the snapshot is empty, as taking it means serializing the whole level again. Snapshots are cached with the bytes, so
+// reloading the scene to pick up an edited patch only pays for deserializing.
+auto LoadLevel(const std::string& path, nc::Registry* registry, nc::asset::NcAsset& ncAsset, bool snapshot) -> SceneSnapshot;
+
+// Path a level's patch is read from and written to
+inline auto GetPatchPath(std::string_view levelPath) -> std::string
+{
+    return std::string{levelPath} + ".patch";
+}
+} // namespace game
@@ -2,12 +2,29 @@
 #include "Assets.h"
 #include "ncengine/graphics/SkeletalAnimator.h"
 #include "Event.h"
+#include "InfectedTreeIndex.h"
+#include "ParticleBudget.h"
+#include "ParticleBurstPool.h"
+#include "TriggerEventQueue.h"
+#include "VoiceManager.h"
 
 #include <algorithm>
 #include <ranges>
 
 namespace
 {
+const auto MorphSfxProperties = nc::audio::AudioSourceProperties{
+    .gain = 2.0f,
+    .outerRadius = 60.0f,
+    .spatialize = true
+};
+
+void PlayMorphSfx(nc::ecs::Ecs world, nc::Entity tree, std::string_view clip)
+{
+    const auto position = world.Get<nc::Transform>(tree)->Position();
+    game::GetComponentByEntityTag<game::VoiceManager>(world, game::tag::VoiceManager)->PlayAt(clip, position, MorphSfxProperties);
+}
+
 // Copied from engine, consider exposing this somehow
 auto ToSphereProperties(const nc::physics::VolumeInfo& in) noexcept -> nc::physics::SphereProperties
 {
@@ -27,7 +44,7 @@ auto GetSpreaderFromParent(nc::ecs::Ecs world, nc::Entity parent)
 
 namespace game
 {
-void InfectedTree::Update(nc::ecs::Ecs world, float dt)
+void InfectedTree::Update(nc::ecs::Ecs world, ParticleBudget& particleBudget, float dt)
 {
     m_timeSinceLastSpread += dt;
     if (m_timeSinceLastSpread < RadiusSpreadTime)
@@ -52,12 +69,12 @@ void InfectedTree::Update(nc::ecs::Ecs world, float dt)
         particleInfo.kinematic.velocityMin -= nc::Vector3{0.1f, 0.0f, 0.1f};
         particleInfo.kinematic.velocityMax += nc::Vector3{0.1f, 0.1f, 0.1f};
     }
-    if (particleInfo.emission.periodicEmissionCount < MaxEmissionCount) // nc::Clamp needs template adjustment
+    emitter->SetInfo(particleInfo);
+    if (m_desiredEmissionCount < MaxEmissionCount) // nc::Clamp needs template adjustment
     {
-        particleInfo.emission.periodicEmissionCount += 1;
+        m_desiredEmissionCount += 1;
+        particleBudget.SetDesiredCount(ParentEntity(), m_desiredEmissionCount);
     }
-
-    emitter->SetInfo(particleInfo);
 }
 
 auto CreateTreeBase(nc::ecs::Ecs world,
@@ -86,33 +103,37 @@ auto CreateTreeBase(nc::ecs::Ecs world,
 void AttachHealthyTree(nc::ecs::Ecs world, nc::Entity tree)
 {
     world.Emplace<HealthyTree>(tree);
-    auto onTriggerEnter = [](nc::Entity self, nc::Entity other, nc::Registry* registry)
-    {
-        if (other.Layer() != layer::Spreader)
-            return;
+    auto triggers = GetComponentByEntityTag<TriggerEventQueue>(world, tag::TriggerEventQueue);
+    auto onTriggerEnter = triggers->Enqueue(TriggerPhase::Enter);
+    auto onTriggerExit = triggers->Enqueue(TriggerPhase::Exit);
+    world.Emplace<nc::CollisionLogic>(tree, nullptr, nullptr, onTriggerEnter, onTriggerExit);
 
-        auto tree = registry->Get<HealthyTree>(self);
-        NC_ASSERT(tree, "expected tree");
-        tree->Infect();
-    };
+    ::PlayMorphSfx(world, tree, MorphHealthySfx);
+}
 
-    auto onTriggerExit = [](nc::Entity self, nc::Entity other, nc::Registry* registry)
+void HandleHealthyTreeTriggers(nc::ecs::Ecs world, std::span<const TriggerEvent> events)
+{
+    // Events for a tree are adjacent, so each tree is looked up once however many spreaders came and went
+    for (auto first = events.begin(); first != events.end();)
     {
-        if (other.Layer() != layer::Spreader)
-            return;
+        const auto self = first->self;
+        auto net = 0;
+        for (; first != events.end() && first->self == self; ++first)
+        {
+            if (first->other.Layer() == layer::Spreader)
+                net += first->phase == TriggerPhase::Enter ? 1 : -1;
+        }
 
-        auto tree = registry->Get<HealthyTree>(self);
-        NC_ASSERT(tree, "expected tree");
-        tree->Disinfect();
-    };
+        auto tree = world.Get<HealthyTree>(self);
+        if (!tree)
+            continue; // morphed since the events were reported
 
-    world.Emplace<nc::CollisionLogic>(tree, nullptr, nullptr, onTriggerEnter, onTriggerExit);
+        for (; net > 0; --net)
+            tree->Infect();
 
-    world.Emplace<nc::audio::AudioSource>(tree, MorphHealthySfx, nc::audio::AudioSourceProperties{
-        .gain = 2.0f,
-        .outerRadius = 60.0f,
-        .spatialize = true
-    })->Play();
+        for (; net < 0; ++net)
+            tree->Disinfect();
+    }
 }
 
 void AttachInfectedTree(nc::ecs::Ecs world, nc::Entity tree)
@@ -120,7 +141,7 @@ void AttachInfectedTree(nc::ecs::Ecs world, nc::Entity tree)
     world.Emplace<InfectedTree>(tree);
     world.Emplace<nc::graphics::ParticleEmitter>(tree, nc::graphics::ParticleInfo{
         .emission = nc::graphics::ParticleEmissionInfo{
-            .periodicEmissionCount = 1,
+            .periodicEmissionCount = InfectedTree::InitialEmissionCount,
             .periodicEmissionFrequency = 0.5f
         },
         .init = nc::graphics::ParticleInitInfo{
@@ -143,22 +164,14 @@ void AttachInfectedTree(nc::ecs::Ecs world, nc::Entity tree)
         }
     });
 
-    auto onTriggerEnter = [](nc::Entity self, nc::Entity other, nc::Registry* registry)
-    {
-        if (other.Layer() != layer::Purifier)
-            return;
-
-        // maybe want this to be time-related as well. if so, will have to be moved to system
-        MorphTreeToHealthy(registry->GetEcs(), self);
-    };
-
-    world.Emplace<nc::CollisionLogic>(tree, nullptr, nullptr, onTriggerEnter, nullptr);
+    // Purification is resolved by sweeping the spray through the index rather than by collision
+    const auto transform = world.Get<nc::Transform>(tree);
+    const auto scale = transform->Scale();
+    const auto footprint = 0.5f * std::sqrt(scale.x * scale.x + scale.z * scale.z);
+    GetComponentByEntityTag<InfectedTreeIndex>(world, tag::InfectedTreeIndex)->Insert(tree, transform->Position(), footprint);
 
-    world.Emplace<nc::audio::AudioSource>(tree, MorphInfectedSfx, nc::audio::AudioSourceProperties{
-        .gain = 2.0f,
-        .outerRadius = 60.0f,
-        .spatialize = true
-    })->Play();
+    GetComponentByEntityTag<ParticleBudget>(world, tag::ParticleBudget)->Track(tree, ParticleImportance::Background, InfectedTree::InitialEmissionCount);
+    ::PlayMorphSfx(world, tree, MorphInfectedSfx);
 
     const auto spreader = world.Emplace<nc::Entity>(nc::EntityInfo
     {
@@ -183,17 +196,19 @@ void FinalizeTrees(nc::ecs::Ecs world)
     }
 }
 
-void AttachMorphParticles(nc::ecs::Ecs world, nc::Entity parent, std::string_view particleTexture)
+void FireMorphParticles(nc::ecs::Ecs world, const nc::Vector3& position, std::string_view particleTexture)
 {
-    auto explosion = world.Emplace<nc::Entity>({.parent = parent, .flags = nc::Entity::Flags::NoSerialize});
-    world.Emplace<nc::graphics::ParticleEmitter>(explosion, nc::graphics::ParticleInfo{
-        .emission = nc::graphics::ParticleEmissionInfo{
-            .initialEmissionCount = 50,
-            .periodicEmissionCount = 0,
-            .periodicEmissionFrequency = 0.0f
-        },
+    constexpr auto particleCount = 50u;
+    constexpr auto lifetime = 3.0f;
+    const auto budget = GetComponentByEntityTag<ParticleBudget>(world, tag::ParticleBudget);
+    const auto count = budget->RequestBurst(ParticleImportance::Normal, particleCount, lifetime, position);
+    if (count == 0)
+        return;
+
+    auto pool = GetComponentByEntityTag<ParticleBurstPool>(world, tag::ParticleBurstPool);
+    const auto fired = pool->Fire(world, nc::graphics::ParticleInfo{
         .init = nc::graphics::ParticleInitInfo{
-            .lifetime = 3.0f,
+            .lifetime = lifetime,
             .positionMin = nc::Vector3{0.0f, 0.0f, 0.0f}, // spawn inside tree so can't see them blink in
             .positionMax = nc::Vector3{0.0f, 5.0f, 0.0f},
             .rotationMin = -0.157f,
@@ -210,7 +225,10 @@ void AttachMorphParticles(nc::ecs::Ecs world, nc::Entity parent, std::string_vie
             .rotationOverTimeFactor = 0.0f,
             .scaleOverTimeFactor = -25.0f
         }
-    });
+    }, position, count);
+
+    if (!fired)
+        budget->RefundBurst(count, lifetime);
 }
 
 void MorphTreeToHealthy(nc::ecs::Ecs world, nc::Entity target)
@@ -219,10 +237,12 @@ void MorphTreeToHealthy(nc::ecs::Ecs world, nc::Entity target)
     const auto pos = transform->Position();
     const auto rot = transform->Rotation();
     const auto scl = transform->Scale();
+    GetComponentByEntityTag<ParticleBudget>(world, tag::ParticleBudget)->Untrack(target);
+    GetComponentByEntityTag<InfectedTreeIndex>(world, tag::InfectedTreeIndex)->Remove(target, pos);
     world.Remove<nc::Entity>(target);
     auto tree = CreateTreeBase(world, pos, rot, scl, tag::HealthyTree, layer::HealthyTree, Tree01Mesh, HealthyTree01Material);
     AttachHealthyTree(world, tree);
-    AttachMorphParticles(world, tree, MorphHealthyParticle);
+    FireMorphParticles(world, pos, MorphHealthyParticle);
 }
 
 void MorphTreeToInfected(nc::ecs::Ecs world, nc::Entity target)
@@ -232,10 +252,11 @@ void MorphTreeToInfected(nc::ecs::Ecs world, nc::Entity target)
     const auto pos = transform->Position();
     const auto rot = transform->Rotation();
     const auto scl = transform->Scale();
+    GetComponentByEntityTag<ParticleBudget>(world, tag::ParticleBudget)->Untrack(target);
     world.Remove<nc::Entity>(target);
     auto tree = CreateTreeBase(world, pos, rot, scl, tag::InfectedTree, layer::InfectedTree, Tree01Mesh, InfectedTree01Material);
     AttachInfectedTree(world, tree);
-    AttachMorphParticles(world, tree, MorphInfectedParticle);
+    FireMorphParticles(world, pos, MorphInfectedParticle);
 }
 
 void RegisterTreeComponents(nc::ecs::ComponentRegistry& registry)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Core.h"
+#include "TriggerEventQueue.h"
 
 #include "ncengine/utility/Signal.h"
 
@@ -8,6 +9,8 @@
 
 namespace game
 {
+class ParticleBudget;
+
 class HealthyTree : public nc::ComponentBase
 {
     public:
@@ -46,15 +49,17 @@ class InfectedTree : public nc::ComponentBase
         static constexpr float RadiusGrowthAmount = 1.0f;
         static constexpr float RadiusSpreadTime = 1.0f;
         static constexpr float MaxSpreadRadius = 45.0f;
+        static constexpr unsigned InitialEmissionCount = 1;
         static constexpr unsigned MaxEmissionCount = 100;
 
         InfectedTree(nc::Entity self)
             : nc::ComponentBase{self} {}
 
-        void Update(nc::ecs::Ecs, float dt);
+        void Update(nc::ecs::Ecs, ParticleBudget& particleBudget, float dt);
 
     private:
         float m_timeSinceLastSpread = 0.0f;
+        unsigned m_desiredEmissionCount = InitialEmissionCount; // the budget decides how many are actually emitted
 };
 } // namespace game
 
@@ -91,6 +96,9 @@ auto CreateTreeBase(nc::ecs::Ecs world,
 // Attach logic to anything with HealthyTree/InfectedTree layers
 void FinalizeTrees(nc::ecs::Ecs world);
 
+// Applies spreaders entering and leaving healthy trees
+void HandleHealthyTreeTriggers(nc::ecs::Ecs world, std::span<const TriggerEvent> events);
+
 // Replace target with a healthy tree
 void MorphTreeToHealthy(nc::ecs::Ecs world, nc::Entity target);
 
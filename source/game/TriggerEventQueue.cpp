@@ -0,0 +1,37 @@
+#include "TriggerEventQueue.h"
+
+namespace game
+{
+TriggerEventQueue::TriggerEventQueue(nc::Entity self)
+    : nc::FreeComponent{self}
+{
+}
+
+void TriggerEventQueue::Subscribe(nc::Entity::layer_type layer, TriggerHandler handler)
+{
+    NC_ASSERT(std::ranges::find(m_batches, layer, &Batch::layer) == m_batches.end(), "Layer already has a trigger handler");
+    m_batches.emplace_back(layer, handler, std::vector<TriggerEvent>{});
+}
+
+void TriggerEventQueue::Push(const TriggerEvent& event)
+{
+    const auto pos = std::ranges::find(m_batches, event.self.Layer(), &Batch::layer);
+    NC_ASSERT(pos != m_batches.end(), fmt::format("No trigger handler for layer '{}'", event.self.Layer()));
+    pos->events.push_back(event);
+}
+
+void TriggerEventQueue::Run(nc::Entity, nc::Registry* registry)
+{
+    auto world = registry->GetEcs();
+    for (auto& batch : m_batches)
+    {
+        if (batch.events.empty())
+            continue;
+
+        std::swap(batch.events, m_handling);
+        std::ranges::stable_sort(m_handling, {}, [](const TriggerEvent& event) { return event.self.Index(); });
+        batch.handler(world, m_handling);
+        m_handling.clear();
+    }
+}
+} // namespace game
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Core.h"
+
+namespace game
+{
+enum class TriggerPhase : uint8_t
+{
+    Enter,
+    Exit
+};
+
+struct TriggerEvent
+{
+    nc::Entity self; // the entity whose CollisionLogic reported the event
+    nc::Entity other;
+    TriggerPhase phase;
+};
+
+// Handlers get every event for their layer from the last physics step, sorted by 'self' so events for the same entity are
+// adjacent and in the order they happened
+using TriggerHandler = void(*)(nc::ecs::Ecs world, std::span<const TriggerEvent> events);
+
+// Collects trigger events into contiguous per-layer batches instead of handling each one as it's reported, and hands
+// each batch to its layer's handler once per fixed step. Dispatching per frame would let a frame with several steps
+// fold an entity's enter and exit from different steps together, so handlers only ever see one step's events.
+class TriggerEventQueue : public nc::FreeComponent
+{
+    public:
+        explicit TriggerEventQueue(nc::Entity self);
+
+        void Subscribe(nc::Entity::layer_type layer, TriggerHandler handler);
+
+        // A CollisionLogic callback that queues events for the subscriber to the reporting entity's layer
+        auto Enqueue(TriggerPhase phase)
+        {
+            return [this, phase](nc::Entity self, nc::Entity other, nc::Registry*)
+            {
+                Push(TriggerEvent{self, other, phase});
+            };
+        }
+
+        void Push(const TriggerEvent& event);
+        void Run(nc::Entity self, nc::Registry* registry);
+
+    private:
+        struct Batch
+        {
+            nc::Entity::layer_type layer;
+            TriggerHandler handler;
+            std::vector<TriggerEvent> events;
+        };
+
+        std::vector<Batch> m_batches;
+        std::vector<TriggerEvent> m_handling; // so handlers can cause new events without invalidating their batch
+};
+} // namespace game
@@ -1,6 +1,8 @@
 #include "UI.h"
+#include "AnimationCrowd.h"
 #include "Core.h"
 #include "Event.h"
+#include "GameInput.h"
 
 #include "ncengine/ui/ImGuiStyle.h"
 #include "ncengine/ui/ImGuiUtility.h"
@@ -32,17 +34,19 @@ void GameUI::Draw()
     const auto windowDimensions = nc::window::GetDimensions();
     const auto screenExtent = nc::window::GetScreenExtent();
 
-    if (nc::input::KeyDown(hotkey::ToggleMenu))
+    if (input::FrameKeyDown(hotkey::ToggleMenu))
     {
         m_menuOpen = !m_menuOpen;
     }
 
 #ifndef GAME_PROD_BUILD
-    ImGui::SetNextWindowPos({windowDimensions.x - 90, 0}, ImGuiCond_Always);
-    ImGui::SetNextWindowSize({90, 40});
+    ImGui::SetNextWindowPos({windowDimensions.x - 240, 0}, ImGuiCond_Always);
+    ImGui::SetNextWindowSize({240, 56});
     if (ImGui::Begin("DebugUI", nullptr, g_windowFlags))
     {
+        const auto& animationStats = GetAnimationFreezeStats();
         ImGui::Text("fps: %.1f", ImGui::GetIO().Framerate);
+        ImGui::Text("animators frozen: %zu/%zu", animationStats.frozen, animationStats.animators);
     }
 
     ImGui::End();
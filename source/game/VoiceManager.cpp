@@ -0,0 +1,184 @@
+#include "VoiceManager.h"
+
+namespace
+{
+// Loudness at the listener, roughly matching the engine's linear rolloff between the inner and outer radius.
+// Older requests lose priority, since starting a sound late is worse than skipping it.
+auto Audibility(const nc::audio::AudioSourceProperties& props, const nc::Vector3& position, const nc::Vector3& listener, float age) -> float
+{
+    auto attenuation = 1.0f;
+    if (props.spatialize)
+    {
+        const auto distance = nc::Distance(position, listener);
+        const auto range = props.outerRadius - props.innerRadius;
+        attenuation = range > 0.0f ? std::clamp(1.0f - (distance - props.innerRadius) / range, 0.0f, 1.0f)
+                                   : (distance <= props.innerRadius ? 1.0f : 0.0f);
+    }
+
+    return props.gain * attenuation / (1.0f + age);
+}
+} // anonymous namespace
+
+namespace game
+{
+VoiceManager::VoiceManager(nc::Entity self, nc::ecs::Ecs world)
+    : nc::FreeComponent{self},
+      m_world{world}
+{
+    m_real.reserve(RealVoiceCount);
+}
+
+void VoiceManager::Play(nc::Entity source)
+{
+    Submit(Command{source, true, m_runs}, true);
+}
+
+void VoiceManager::Stop(nc::Entity source)
+{
+    Submit(Command{source, false, m_runs}, true);
+}
+
+void VoiceManager::PlayAt(std::string_view clip, const nc::Vector3& position, const nc::audio::AudioSourceProperties& properties)
+{
+    m_virtual.emplace_back(clip, position, properties, 0.0f, 0.0f, 0ull);
+}
+
+auto VoiceManager::IsPlaying(nc::Entity source) -> bool
+{
+    const auto held = std::ranges::find(m_deferred.rbegin(), m_deferred.rend(), source, &Command::source);
+    if (held != m_deferred.rend())
+        return held->play;
+
+    const auto audioSource = m_world.Get<nc::audio::AudioSource>(source);
+    return audioSource && audioSource->IsPlaying();
+}
+
+void VoiceManager::Submit(const Command& command, bool canDefer)
+{
+    auto source = m_world.Get<nc::audio::AudioSource>(command.source);
+    if (!source)
+    {
+        if (canDefer)
+            m_deferred.push_back(command);
+        else
+            NC_LOG_WARNING(fmt::format("Dropping audio command for entity {}, it has no AudioSource", command.source.Index()));
+
+        return;
+    }
+
+    // Anything held for this source up to now was requested earlier, so it's superseded
+    std::erase_if(m_deferred, [&command](const Command& deferred)
+    {
+        return deferred.source == command.source && deferred.heldAt <= command.heldAt;
+    });
+    if (command.play)
+        source->Play();
+    else if (source->IsPlaying())
+        source->Stop();
+}
+
+void VoiceManager::Run(nc::Entity, nc::Registry*, float dt)
+{
+    // Commands held before the last Run came from an earlier frame, so their sources have been committed since and they
+    // get one more try. Anything held since then may be for a source emplaced this frame, ahead of this Run, and waits.
+    m_retrying.swap(m_deferred);
+    for (const auto& command : m_retrying)
+    {
+        if (command.heldAt < m_runs)
+            Submit(command, false);
+        else
+            m_deferred.push_back(command);
+    }
+
+    m_retrying.clear();
+    ++m_runs;
+    if (m_listener.Valid())
+        UpdateVoices(dt);
+}
+
+void VoiceManager::UpdateVoices(float dt)
+{
+    const auto listener = m_world.Get<nc::Transform>(m_listener)->Position();
+
+    // Finished voices hand their emitter back to the pool
+    std::erase_if(m_real, [&](Voice& voice)
+    {
+        auto& emitter = m_emitters[voice.emitter];
+        if (m_world.Get<nc::audio::AudioSource>(emitter.entity)->IsPlaying())
+        {
+            voice.age += dt;
+            voice.audibility = ::Audibility(voice.properties, voice.position, listener, voice.age);
+            return false;
+        }
+
+        emitter.busy = false;
+        return true;
+    });
+
+    // Drop requests that can't be heard or are too late to matter
+    std::erase_if(m_virtual, [&](Voice& voice)
+    {
+        voice.age += dt;
+        voice.audibility = ::Audibility(voice.properties, voice.position, listener, voice.age);
+        return voice.age > MaxVirtualAge || voice.audibility <= 0.0f;
+    });
+
+    if (m_virtual.empty())
+        return;
+
+    // Promote the loudest virtual voices into free slots, then let any left over steal from much quieter real ones
+    std::ranges::sort(m_virtual, std::ranges::greater{}, &Voice::audibility);
+    auto promoted = 0ull;
+    for (auto& candidate : m_virtual)
+    {
+        if (m_real.size() >= RealVoiceCount)
+        {
+            auto quietest = std::ranges::min_element(m_real, {}, &Voice::audibility);
+            if (candidate.audibility < quietest->audibility * StealThreshold)
+                break;
+
+            auto& emitter = m_emitters[quietest->emitter];
+            m_world.Get<nc::audio::AudioSource>(emitter.entity)->Stop();
+            emitter.busy = false;
+            m_real.erase(quietest);
+        }
+
+        Start(candidate);
+        m_real.push_back(candidate);
+        ++promoted;
+    }
+
+    m_virtual.erase(m_virtual.begin(), m_virtual.begin() + static_cast<std::ptrdiff_t>(promoted));
+}
+
+void VoiceManager::Start(Voice& voice)
+{
+    auto pos = std::ranges::find_if(m_emitters, [&voice](const Emitter& emitter)
+    {
+        return !emitter.busy && emitter.clip == voice.clip;
+    });
+
+    if (pos != m_emitters.end())
+    {
+        pos->busy = true;
+        voice.emitter = static_cast<size_t>(std::distance(m_emitters.begin(), pos));
+        m_world.Get<nc::Transform>(pos->entity)->SetPosition(voice.position);
+        auto source = m_world.Get<nc::audio::AudioSource>(pos->entity);
+        source->SetProperties(voice.properties);
+        source->Play();
+        return;
+    }
+
+    // Pool only grows to the most voices of this clip that have played at once
+    const auto entity = m_world.Emplace<nc::Entity>({
+        .position = voice.position,
+        .parent = ParentEntity(),
+        .tag = "SfxEmitter",
+        .flags = nc::Entity::Flags::NoSerialize
+    });
+
+    voice.emitter = m_emitters.size();
+    m_emitters.emplace_back(entity, voice.clip, true);
+    m_world.Emplace<nc::audio::AudioSource>(entity, voice.clip, voice.properties)->Play();
+}
+} // namespace game
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Core.h"
+
+namespace game
+{
+// Owns all game-driven audio playback. Play and stop take effect right away on the game thread - the engine doesn't
+// expose its mixer thread, so there is nothing to hand them off to. Only commands for a source emplaced this frame, and
+// not yet committed, are held. They're retried from the first Run of a later frame, once the source has been committed.
+//
+// One-shot spatial sounds play from a pool of reusable emitters, and how many play at once is capped. Requests are
+// ranked by how audible they'd be at the listener, and only the loudest get a real voice. The rest are virtual -
+// tracked, but silent - until a voice frees up, or until they're too old to be worth starting.
+class VoiceManager : public nc::FreeComponent
+{
+    public:
+        static constexpr auto VoiceCount = 16u;
+        static constexpr auto ReservedVoiceCount = 4u; // CharacterAudio's players don't go through the voice budget
+        static constexpr auto RealVoiceCount = VoiceCount - ReservedVoiceCount;
+        static constexpr auto MaxVirtualAge = 0.5f;
+        static constexpr auto StealThreshold = 1.5f; // a virtual voice must be this much louder to cut off a real one
+
+        VoiceManager(nc::Entity self, nc::ecs::Ecs world);
+
+        void RegisterListener(nc::Entity listener) { m_listener = listener; }
+
+        // Clip names must outlive the voice, i.e. use the asset constants
+        void Play(nc::Entity source);
+        void Stop(nc::Entity source);
+        void PlayAt(std::string_view clip, const nc::Vector3& position, const nc::audio::AudioSourceProperties& properties);
+
+        // For a source whose commands are still held, reports what was last requested
+        auto IsPlaying(nc::Entity source) -> bool;
+
+        void Run(nc::Entity self, nc::Registry* registry, float dt);
+
+        auto GetRealVoiceCount() const noexcept { return m_real.size(); }
+        auto GetVirtualVoiceCount() const noexcept { return m_virtual.size(); }
+        auto GetEmitterCount() const noexcept { return m_emitters.size(); }
+
+    private:
+        struct Command
+        {
+            nc::Entity source;
+            bool play;
+            size_t heldAt; // m_runs when it was held
+        };
+
+        // An AudioSource's clip is fixed, so emitters are only reused for the clip they were created with
+        struct Emitter
+        {
+            nc::Entity entity;
+            std::string_view clip;
+            bool busy;
+        };
+
+        struct Voice
+        {
+            std::string_view clip;
+            nc::Vector3 position;
+            nc::audio::AudioSourceProperties properties;
+            float age;
+            float audibility;
+            size_t emitter;
+        };
+
+        nc::ecs::Ecs m_world;
+        std::vector<Command> m_deferred;
+        std::vector<Command> m_retrying;
+        size_t m_runs = 0;
+        nc::Entity m_listener = nc::Entity::Null();
+        std::vector<Emitter> m_emitters;
+        std::vector<Voice> m_real;
+        std::vector<Voice> m_virtual;
+
+        void Submit(const Command& command, bool canDefer);
+        void UpdateVoices(float dt);
+        void Start(Voice& voice);
+};
+} // namespace game
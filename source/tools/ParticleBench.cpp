@@ -0,0 +1,150 @@
+#include "ParticleKernel.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+// Usage: particle-bench
+//
+// Integrates 100k particles with every kernel the cpu supports, checks each against the scalar kernel, and reports
+// throughput. Settings match the blight emitters in Tree.cpp, with lifetimes long enough that most particles survive
+// the timed steps, so throughput isn't dominated by removals.
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr auto ParticleCount = 100000ull;
+constexpr auto VerifySteps = 600;
+constexpr auto TimedSteps = 1000;
+constexpr auto Dt = 1.0f / 60.0f;
+constexpr auto Tolerance = 1e-5f;
+constexpr auto Kernels = std::array{game::ParticleKernel::Scalar, game::ParticleKernel::Sse, game::ParticleKernel::Avx2};
+constexpr auto Kinematics = game::ParticleKinematics{.rotationOverTimeFactor = 0.5f, .scaleOverTimeFactor = -0.02f};
+
+auto MakeStore(float minLifetime, float maxLifetime) -> game::ParticleStore
+{
+    auto rng = std::mt19937{42u};
+    auto position = std::uniform_real_distribution<float>{0.0f, 5.0f};
+    auto velocity = std::uniform_real_distribution<float>{-0.35f, 0.5f};
+    auto rotation = std::uniform_real_distribution<float>{-0.157f, 0.157f};
+    auto angular = std::uniform_real_distribution<float>{-1.0f, 1.0f};
+    auto scale = std::uniform_real_distribution<float>{0.005f, 0.6f};
+    auto lifetime = std::uniform_real_distribution<float>{minLifetime, maxLifetime};
+
+    auto store = game::ParticleStore{};
+    store.Reserve(ParticleCount);
+    for (auto i = 0ull; i < ParticleCount; ++i)
+    {
+        store.Add(position(rng), position(rng), position(rng),
+                  velocity(rng), velocity(rng), velocity(rng),
+                  rotation(rng), angular(rng), scale(rng), lifetime(rng));
+    }
+
+    return store;
+}
+
+auto MaxDifference(const game::ParticleStore& a, const game::ParticleStore& b) -> float
+{
+    if (a.Size() != b.Size())
+        return INFINITY;
+
+    auto worst = 0.0f;
+    auto compare = [&worst](const std::vector<float>& lhs, const std::vector<float>& rhs)
+    {
+        for (auto i = 0ull; i < lhs.size(); ++i)
+        {
+            worst = std::max(worst, std::abs(lhs[i] - rhs[i]));
+        }
+    };
+
+    compare(a.positionX, b.positionX);
+    compare(a.positionY, b.positionY);
+    compare(a.positionZ, b.positionZ);
+    compare(a.rotation, b.rotation);
+    compare(a.scale, b.scale);
+    compare(a.age, b.age);
+    return worst;
+}
+
+// Lifetimes here are short enough that particles expire throughout, so removal order is checked too
+auto Verify(game::ParticleKernel kernel) -> float
+{
+    auto reference = ::MakeStore(1.0f, 12.0f);
+    auto store = reference;
+    for (auto step = 0; step < VerifySteps; ++step)
+    {
+        game::IntegrateParticles(reference, Kinematics, Dt, game::ParticleKernel::Scalar);
+        game::IntegrateParticles(store, Kinematics, Dt, kernel);
+    }
+
+    return ::MaxDifference(reference, store);
+}
+
+auto Measure(game::ParticleKernel kernel) -> double
+{
+    auto store = ::MakeStore(100.0f, 200.0f);
+    game::IntegrateParticles(store, Kinematics, Dt, kernel); // warm up
+
+    const auto begin = Clock::now();
+    for (auto step = 0; step < TimedSteps; ++step)
+    {
+        game::IntegrateParticles(store, Kinematics, Dt, kernel);
+    }
+
+    const auto milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    return static_cast<double>(ParticleCount) * TimedSteps / milliseconds;
+}
+} // anonymous namespace
+
+int main()
+{
+    try
+    {
+        std::cout << "particle-bench: " << ParticleCount << " particles, " << TimedSteps << " steps, best kernel for this cpu is "
+                  << game::ToString(game::GetBestParticleKernel()) << "\n\n"
+                  << std::setw(8) << "kernel" << std::setw(18) << "particles/ms" << std::setw(10) << "speedup"
+                  << std::setw(14) << "max error" << '\n';
+
+        auto failed = false;
+        auto scalarRate = 0.0;
+        for (auto kernel : Kernels)
+        {
+            if (!game::IsSupported(kernel))
+            {
+                std::cout << std::setw(8) << game::ToString(kernel) << "  not supported on this cpu\n";
+                continue;
+            }
+
+            const auto error = ::Verify(kernel);
+            const auto rate = ::Measure(kernel);
+            if (kernel == game::ParticleKernel::Scalar)
+                scalarRate = rate;
+
+            const auto passed = error <= Tolerance;
+            failed = failed || !passed;
+            std::cout << std::setw(8) << game::ToString(kernel) << std::fixed << std::setprecision(0) << std::setw(18) << rate
+                      << std::setprecision(2) << std::setw(9) << rate / scalarRate << 'x'
+                      << std::scientific << std::setprecision(1) << std::setw(14) << error << std::defaultfloat
+                      << (passed ? "" : "  MISMATCH") << '\n';
+        }
+
+        if (failed)
+        {
+            std::cerr << "\nparticle-bench: kernel results differ from the scalar reference\n";
+            return 1;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "particle-bench failed: " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
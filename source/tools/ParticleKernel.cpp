@@ -0,0 +1,197 @@
+#include "ParticleKernel.h"
+
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define GAME_PARTICLES_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define GAME_PARTICLES_X86 0
+#endif
+
+// msvc allows avx2 intrinsics without /arch:AVX2, gcc and clang need the function opted in
+#if GAME_PARTICLES_X86 && !defined(_MSC_VER)
+#define GAME_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define GAME_TARGET_AVX2
+#endif
+
+namespace
+{
+struct Step
+{
+    float dt;
+    float rotation;
+    float scale;
+};
+
+void IntegrateScalar(game::ParticleStore& s, const Step& step, size_t begin, size_t end)
+{
+    for (auto i = begin; i < end; ++i)
+    {
+        s.positionX[i] += s.velocityX[i] * step.dt;
+        s.positionY[i] += s.velocityY[i] * step.dt;
+        s.positionZ[i] += s.velocityZ[i] * step.dt;
+        s.rotation[i] += s.angularVelocity[i] * step.rotation;
+        s.scale[i] = std::max(s.scale[i] + step.scale, 0.0f);
+        s.age[i] += step.dt;
+    }
+}
+
+#if GAME_PARTICLES_X86
+auto IntegrateSse(game::ParticleStore& s, const Step& step) -> size_t
+{
+    const auto dt = _mm_set1_ps(step.dt);
+    const auto rotationStep = _mm_set1_ps(step.rotation);
+    const auto scaleStep = _mm_set1_ps(step.scale);
+    const auto zero = _mm_setzero_ps();
+
+    const auto count = s.Size() / 4 * 4;
+    for (auto i = 0ull; i < count; i += 4)
+    {
+        _mm_storeu_ps(&s.positionX[i], _mm_add_ps(_mm_loadu_ps(&s.positionX[i]), _mm_mul_ps(_mm_loadu_ps(&s.velocityX[i]), dt)));
+        _mm_storeu_ps(&s.positionY[i], _mm_add_ps(_mm_loadu_ps(&s.positionY[i]), _mm_mul_ps(_mm_loadu_ps(&s.velocityY[i]), dt)));
+        _mm_storeu_ps(&s.positionZ[i], _mm_add_ps(_mm_loadu_ps(&s.positionZ[i]), _mm_mul_ps(_mm_loadu_ps(&s.velocityZ[i]), dt)));
+        _mm_storeu_ps(&s.rotation[i], _mm_add_ps(_mm_loadu_ps(&s.rotation[i]), _mm_mul_ps(_mm_loadu_ps(&s.angularVelocity[i]), rotationStep)));
+        _mm_storeu_ps(&s.scale[i], _mm_max_ps(_mm_add_ps(_mm_loadu_ps(&s.scale[i]), scaleStep), zero));
+        _mm_storeu_ps(&s.age[i], _mm_add_ps(_mm_loadu_ps(&s.age[i]), dt));
+    }
+
+    return count;
+}
+
+GAME_TARGET_AVX2 auto IntegrateAvx2(game::ParticleStore& s, const Step& step) -> size_t
+{
+    const auto dt = _mm256_set1_ps(step.dt);
+    const auto rotationStep = _mm256_set1_ps(step.rotation);
+    const auto scaleStep = _mm256_set1_ps(step.scale);
+    const auto zero = _mm256_setzero_ps();
+
+    const auto count = s.Size() / 8 * 8;
+    for (auto i = 0ull; i < count; i += 8)
+    {
+        _mm256_storeu_ps(&s.positionX[i], _mm256_add_ps(_mm256_loadu_ps(&s.positionX[i]), _mm256_mul_ps(_mm256_loadu_ps(&s.velocityX[i]), dt)));
+        _mm256_storeu_ps(&s.positionY[i], _mm256_add_ps(_mm256_loadu_ps(&s.positionY[i]), _mm256_mul_ps(_mm256_loadu_ps(&s.velocityY[i]), dt)));
+        _mm256_storeu_ps(&s.positionZ[i], _mm256_add_ps(_mm256_loadu_ps(&s.positionZ[i]), _mm256_mul_ps(_mm256_loadu_ps(&s.velocityZ[i]), dt)));
+        _mm256_storeu_ps(&s.rotation[i], _mm256_add_ps(_mm256_loadu_ps(&s.rotation[i]), _mm256_mul_ps(_mm256_loadu_ps(&s.angularVelocity[i]), rotationStep)));
+        _mm256_storeu_ps(&s.scale[i], _mm256_max_ps(_mm256_add_ps(_mm256_loadu_ps(&s.scale[i]), scaleStep), zero));
+        _mm256_storeu_ps(&s.age[i], _mm256_add_ps(_mm256_loadu_ps(&s.age[i]), dt));
+    }
+
+    return count;
+}
+
+auto CpuSupportsAvx2() -> bool
+{
+#ifdef _MSC_VER
+    int info[4] = {};
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    // avx2 also needs the os to save ymm registers
+    __cpuid(info, 1);
+    const auto osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+} // anonymous namespace
+
+namespace game
+{
+void ParticleStore::Reserve(size_t count)
+{
+    for (auto* array : {&positionX, &positionY, &positionZ, &velocityX, &velocityY, &velocityZ, &rotation, &angularVelocity, &scale, &age, &lifetime})
+    {
+        array->reserve(count);
+    }
+}
+
+void ParticleStore::Add(float x, float y, float z, float vx, float vy, float vz, float rot, float angular, float particleScale, float particleLifetime)
+{
+    positionX.push_back(x);
+    positionY.push_back(y);
+    positionZ.push_back(z);
+    velocityX.push_back(vx);
+    velocityY.push_back(vy);
+    velocityZ.push_back(vz);
+    rotation.push_back(rot);
+    angularVelocity.push_back(angular);
+    scale.push_back(particleScale);
+    age.push_back(0.0f);
+    lifetime.push_back(particleLifetime);
+}
+
+void ParticleStore::SwapRemove(size_t index)
+{
+    for (auto* array : {&positionX, &positionY, &positionZ, &velocityX, &velocityY, &velocityZ, &rotation, &angularVelocity, &scale, &age, &lifetime})
+    {
+        (*array)[index] = array->back();
+        array->pop_back();
+    }
+}
+
+auto ToString(ParticleKernel kernel) -> std::string_view
+{
+    switch (kernel)
+    {
+        case ParticleKernel::Scalar: return "scalar";
+        case ParticleKernel::Sse:    return "sse";
+        case ParticleKernel::Avx2:   return "avx2";
+    }
+
+    return "unknown";
+}
+
+auto IsSupported(ParticleKernel kernel) -> bool
+{
+#if GAME_PARTICLES_X86
+    static const auto hasAvx2 = ::CpuSupportsAvx2();
+    return kernel != ParticleKernel::Avx2 || hasAvx2;
+#else
+    return kernel == ParticleKernel::Scalar;
+#endif
+}
+
+auto GetBestParticleKernel() -> ParticleKernel
+{
+    if (IsSupported(ParticleKernel::Avx2))
+        return ParticleKernel::Avx2;
+
+    return IsSupported(ParticleKernel::Sse) ? ParticleKernel::Sse : ParticleKernel::Scalar;
+}
+
+void IntegrateParticles(ParticleStore& store, const ParticleKinematics& kinematics, float dt, ParticleKernel kernel)
+{
+    const auto step = Step{dt, kinematics.rotationOverTimeFactor * dt, kinematics.scaleOverTimeFactor * dt};
+    auto done = 0ull;
+
+#if GAME_PARTICLES_X86
+    if (kernel == ParticleKernel::Avx2 && IsSupported(kernel))
+        done = ::IntegrateAvx2(store, step);
+    else if (kernel != ParticleKernel::Scalar)
+        done = ::IntegrateSse(store, step);
+#else
+    static_cast<void>(kernel);
+#endif
+
+    ::IntegrateScalar(store, step, done, store.Size());
+
+    // Back to front, so every kernel removes particles in the same order
+    for (auto i = store.Size(); i-- > 0;)
+    {
+        if (store.age[i] >= store.lifetime[i])
+            store.SwapRemove(i);
+    }
+}
+} // namespace game
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// No engine dependencies in here - this is the per-particle kinematic step that the blight, purify and quest indicator
+// emitters rely on, as a standalone kernel that runs and can be measured without a GPU
+
+namespace game
+{
+// The ParticleKinematicInfo fields that apply every step. Velocities are per particle.
+struct ParticleKinematics
+{
+    float rotationOverTimeFactor = 1.0f;
+    float scaleOverTimeFactor = 0.0f;
+};
+
+// Structure-of-arrays particle storage. Every array always holds Size() elements.
+struct ParticleStore
+{
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> velocityX, velocityY, velocityZ;
+    std::vector<float> rotation, angularVelocity;
+    std::vector<float> scale;
+    std::vector<float> age, lifetime;
+
+    auto Size() const noexcept { return age.size(); }
+    void Reserve(size_t count);
+    void Add(float x, float y, float z, float vx, float vy, float vz, float rot, float angular, float particleScale, float particleLifetime);
+    void SwapRemove(size_t index);
+};
+
+enum class ParticleKernel : uint8_t
+{
+    Scalar,
+    Sse,
+    Avx2
+};
+
+auto ToString(ParticleKernel kernel) -> std::string_view;
+
+// Whether this build and cpu can run a kernel
+auto IsSupported(ParticleKernel kernel) -> bool;
+auto GetBestParticleKernel() -> ParticleKernel;
+
+// Advance every particle by dt, then remove any that have outlived their lifetime. All kernels produce identical
+// results - the vector paths use the same operations in the same order as the scalar one, with no fused multiply-add.
+void IntegrateParticles(ParticleStore& store, const ParticleKinematics& kinematics, float dt, ParticleKernel kernel);
+} // namespace game
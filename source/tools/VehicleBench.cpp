@@ -0,0 +1,183 @@
+#include "ChainSolver.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+
+// Usage: vehicle-bench
+//
+// Drives the vehicle chain through a scripted run - pulling away, lunging, weaving, reversing and spinning in place -
+// with a range of solver settings, and reports how far the hitches drift apart and what each fixed step costs. The
+// train and driving constants match CreateVehicle and CharacterController.
+//
+// The 'joints' rows are ChainSolver too, run once per fixed step with several iterations and softened and biased like
+// CreateVehicle's front hitch. They approximate the NcPhysics::AddJoint math only - the engine isn't linked here, so
+// neither its joints nor VehicleChain's hand-off to the engine's bodies is measured.
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr auto FixedDt = 1.0f / 60.0f;
+constexpr auto TimedRuns = 200;
+constexpr auto StableSeparation = 0.05f;
+
+// CreateVehicle's joints
+constexpr auto JointBias = 0.3f;
+constexpr auto JointSoftness = 0.4f;
+
+// CharacterController
+constexpr auto MoveAcceleration = 0.5f;
+constexpr auto MoveVelocityUpperBound = 10.0f;
+constexpr auto LungeVelocityUpperBound = MoveVelocityUpperBound * 1.75f;
+constexpr auto ReverseVelocity = MoveVelocityUpperBound * 0.5f;
+constexpr auto TurnAcceleration = 0.05f;
+constexpr auto MaxTurnVelocity = 1.5f;
+
+struct Input
+{
+    float until; // seconds
+    bool forward;
+    bool lunge;
+    bool back;
+    float turn; // -1 left, 1 right
+};
+
+constexpr auto Script = std::array{
+    Input{1.0f, false, false, false, 0.0f},
+    Input{4.0f, true, false, false, 0.0f},
+    Input{6.0f, true, true, false, 0.0f},
+    Input{9.0f, true, true, false, -1.0f},
+    Input{11.0f, true, false, false, 1.0f},
+    Input{12.0f, false, false, false, 0.0f},
+    Input{14.0f, false, false, true, 0.0f},
+    Input{16.0f, false, false, false, 1.0f}
+};
+
+struct Result
+{
+    float maxSeparation = 0.0f;
+    float meanSeparation = 0.0f;
+    bool finite = true;
+};
+
+// CreateVehicle's train
+auto MakeTrain(const game::ChainSolverSettings& settings) -> game::ChainSolver
+{
+    auto solver = game::ChainSolver{game::ChainPose{0.0f, 0.0f, 0.0f}, settings};
+    solver.AddCar(3.0f, 0.8f, 1.6f, 0.9f, 0.72f);
+    solver.AddCar(1.0f, 0.6f, 1.2f, 0.72f, 0.54f);
+    solver.AddCar(0.2f, 0.4f, 0.8f, 0.54f, 0.36f);
+    return solver;
+}
+
+auto Drive(game::ChainSolver& solver) -> Result
+{
+    auto result = Result{};
+    auto lead = game::ChainPose{0.0f, 0.0f, 0.0f};
+    auto speed = 0.0f;
+    auto turnVelocity = 0.0f;
+    auto steps = 0;
+    auto time = 0.0f;
+    for (const auto& input : Script)
+    {
+        for (; time < input.until; time += FixedDt, ++steps)
+        {
+            if (input.forward)
+                speed = std::min(speed + MoveAcceleration, input.lunge ? LungeVelocityUpperBound : MoveVelocityUpperBound);
+            else
+                speed = std::max(speed - MoveAcceleration * 1.5f, 0.0f);
+
+            const auto velocity = input.back ? speed - ReverseVelocity : speed;
+            turnVelocity = input.turn == 0.0f ? 0.0f : std::clamp(turnVelocity + TurnAcceleration * input.turn, -MaxTurnVelocity, MaxTurnVelocity);
+            lead.yaw += turnVelocity * FixedDt;
+            lead.x += std::sin(lead.yaw) * velocity * FixedDt;
+            lead.z += std::cos(lead.yaw) * velocity * FixedDt;
+
+            solver.Step(lead, FixedDt);
+            const auto separation = solver.GetMaxSeparation();
+            result.finite = result.finite && std::isfinite(separation);
+            result.maxSeparation = std::max(result.maxSeparation, separation);
+            result.meanSeparation += separation;
+        }
+    }
+
+    result.meanSeparation /= static_cast<float>(steps);
+    return result;
+}
+
+auto Measure(const game::ChainSolverSettings& settings) -> double
+{
+    auto steps = 0.0;
+    const auto begin = Clock::now();
+    for (auto run = 0; run < TimedRuns; ++run)
+    {
+        auto solver = ::MakeTrain(settings);
+        ::Drive(solver);
+        steps += static_cast<double>(Script.back().until / FixedDt);
+    }
+
+    return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / steps;
+}
+} // anonymous namespace
+
+int main()
+{
+    try
+    {
+        std::cout << "vehicle-bench: " << Script.back().until << "s scripted run at " << std::setprecision(0) << std::fixed << 1.0f / FixedDt
+                  << "Hz, hitches count as holding under " << std::setprecision(2) << StableSeparation << "m\n\n"
+                  << std::setw(8) << "solver" << std::setw(10) << "substeps" << std::setw(12) << "iterations" << std::setw(12) << "warm start"
+                  << std::setw(16) << "max sep (m)" << std::setw(16) << "mean sep (m)" << std::setw(14) << "ns/step" << '\n';
+
+        auto anyStable = false;
+        const auto report = [&anyStable](const char* name, const game::ChainSolverSettings& settings)
+        {
+            auto solver = ::MakeTrain(settings);
+            const auto result = ::Drive(solver);
+            const auto cost = ::Measure(settings);
+            const auto stable = result.finite && result.maxSeparation < StableSeparation;
+            anyStable = anyStable || stable;
+            std::cout << std::setw(8) << name << std::setw(10) << settings.substeps << std::setw(12) << settings.iterations
+                      << std::setw(12) << (settings.warmStart ? "on" : "off") << std::setprecision(4) << std::setw(16)
+                      << result.maxSeparation << std::setw(16) << result.meanSeparation << std::setprecision(0) << std::setw(14)
+                      << cost << (stable ? "" : "  LOOSE") << '\n';
+        };
+
+        for (auto substeps : {1u, 2u, 4u, 8u})
+        {
+            for (auto warmStart : {false, true})
+            {
+                report("chain", game::ChainSolverSettings{.substeps = substeps, .warmStart = warmStart});
+            }
+        }
+
+        for (auto iterations : {4u, 8u, 16u})
+        {
+            report("joints", game::ChainSolverSettings{
+                .substeps = 1u,
+                .iterations = iterations,
+                .bias = JointBias,
+                .softness = JointSoftness,
+                .warmStart = true
+            });
+        }
+
+        if (!anyStable)
+        {
+            std::cerr << "\nvehicle-bench: no settings kept the chain together\n";
+            return 1;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "vehicle-bench failed: " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}